@@ -0,0 +1,20 @@
+/*
+ * miniz.h - declarations for miniz.c
+ *
+ * miniz ships as a single source file. this exposes its declarations with
+ * the same feature set the miniz target is built with.
+ */
+
+#ifndef MINIZ_H
+#define MINIZ_H
+
+#define MINIZ_NO_STDIO
+#define MINIZ_NO_TIME
+#define MINIZ_NO_ARCHIVE_APIS
+#define MINIZ_NO_ZLIB_COMPATIBLE_NAMES
+
+#define MINIZ_HEADER_FILE_ONLY
+#include "miniz.c"
+#undef MINIZ_HEADER_FILE_ONLY
+
+#endif // MINIZ_H
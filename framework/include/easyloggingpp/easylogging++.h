@@ -1211,9 +1211,12 @@ namespace el {
                                         while (currPath != nullptr) {
                                             builtPath.append(currPath);
                                             builtPath.append(base::consts::kFilePathSeperator);
-#if ELPP_OS_UNIX
+#if ELPP_OS_VITA
                                             status = sceIoMkdir(builtPath.c_str(), ELPP_LOG_PERMS);
                                             currPath = STRTOK(nullptr, base::consts::kFilePathSeperator, 0);
+#elif ELPP_OS_UNIX
+                                            status = mkdir(builtPath.c_str(), ELPP_LOG_PERMS);
+                                            currPath = STRTOK(nullptr, base::consts::kFilePathSeperator, 0);
 #elif ELPP_OS_WINDOWS
                                             status = _mkdir(builtPath.c_str());
                                             currPath = STRTOK(nullptr, base::consts::kFilePathSeperator, &nextTok_);
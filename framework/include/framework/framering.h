@@ -0,0 +1,80 @@
+/*
+ * framering.h - gpu memory that lasts one frame
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef FRAMERING_H
+#define FRAMERING_H
+
+#include <framework/gpumemoryblock.h>
+#include <framework/ringallocator.h>
+
+#include <psp2/gxm.h>
+
+#include <memory>
+#include <vector>
+
+// geometry rewritten while it is on screen cannot go back in to memory the
+// gpu may still be reading for an earlier frame. instead it is written fresh
+// in to this ring every frame it is drawn. the screen fences each frame with
+// a notification and the ring reuses a frame's memory once the gpu has
+// finished with it, so nothing is allocated or freed per frame.
+// only for use from the thread that draws
+class FrameRing
+{
+public:
+	// one per display buffer, see VitaScreen
+	static constexpr unsigned int FRAMES = 3;
+	static constexpr std::size_t SIZE = 256*1024;
+	static constexpr std::size_t ALIGNMENT = 16;
+
+public:
+	static FrameRing *instance(void);
+
+	// beginFrame waits for the gpu to finish the frame last built in the
+	// slot it reuses. endFrame gives the notification to end the scene with
+	void beginFrame(void);
+	const SceGxmNotification *endFrame(void);
+
+	// waits for the gpu to finish every frame it has been given. for the
+	// rare change that cannot be made while earlier frames are in flight
+	void waitIdle(void);
+
+	void *allocate(std::size_t size);
+
+	template <typename T>
+	T *allocate(std::size_t count)
+	{
+		static_assert(alignof(T) <= ALIGNMENT, "type is aligned more strictly than the frame ring");
+		return static_cast<T *>(allocate(count*sizeof(T)));
+	}
+
+	// gpu memory that is replaced rather than rewritten while on screen,
+	// kept until every frame that may have drawn from it is done
+	template <typename T>
+	void release(std::unique_ptr<T> resource)
+	{
+		if (resource)
+		{
+			m_released[m_ring.frame()].emplace_back(std::move(resource));
+		}
+	}
+
+	RingAllocator::Statistics statistics(void) const;
+
+private:
+	FrameRing(void);
+
+private:
+	GpuMemoryBlock<char> m_memory;
+	RingAllocator m_ring;
+	SceGxmNotification m_notifications[FRAMES];
+	std::vector<std::shared_ptr<void>> m_released[FRAMES];
+	unsigned int m_fence{0};
+};
+
+#endif // FRAMERING_H
@@ -0,0 +1,103 @@
+/*
+ * gpuheap.h - small gpu buffers carved from a few mapped blocks
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef GPUHEAP_H
+#define GPUHEAP_H
+
+#include <framework/gpumemoryblock.h>
+#include <framework/heapallocator.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// every memory block is a whole number of pages with its own mapping, which
+// is a lot for the few dozen bytes of a rectangle. the heap maps a region at
+// a time, readable by the gpu, and hands out pieces of it. regions are kept
+// for the life of the application
+class GpuHeap
+{
+public:
+	using Handle = HeapAllocator::Handle;
+	using Statistics = HeapAllocator::Statistics;
+
+	// a single allocation larger than this gets a region to itself
+	static constexpr std::size_t REGION_SIZE = 128*1024;
+
+public:
+	static GpuHeap *instance(void);
+
+	Handle allocate(std::size_t size);
+	void free(Handle handle);
+
+	void *address(Handle handle) const;
+	std::size_t size(Handle handle) const;
+
+	Statistics statistics(void) const;
+
+private:
+	GpuHeap(void) = default;
+
+	void grow(std::size_t size);
+
+private:
+	mutable std::mutex m_mutex;
+	HeapAllocator m_allocator;
+	std::vector<std::unique_ptr<GpuMemoryBlock<char>>> m_regions;
+};
+
+// a typed piece of the gpu heap, with the same interface as GpuMemoryBlock
+// so small vertex and index buffers can use either
+template <typename T>
+class GpuHeapBlock
+{
+	static_assert(alignof(T) <= HeapAllocator::GRANULARITY, "type is aligned more strictly than the gpu heap");
+
+public:
+	GpuHeapBlock(std::size_t count)
+		: m_count(count)
+	{
+		auto heap = GpuHeap::instance();
+
+		m_handle = heap->allocate(count*sizeof(T));
+		m_address = static_cast<T *>(heap->address(m_handle));
+		m_size = heap->size(m_handle);
+	}
+
+	~GpuHeapBlock(void)
+	{
+		GpuHeap::instance()->free(m_handle);
+	}
+
+	GpuHeapBlock(const GpuHeapBlock&) = delete;
+	GpuHeapBlock& operator=(const GpuHeapBlock&) = delete;
+
+	T *address(void) const
+	{
+		return m_address;
+	}
+
+	std::size_t size(void) const
+	{
+		return m_size;
+	}
+
+	std::size_t count(void) const
+	{
+		return m_count;
+	}
+
+private:
+	GpuHeap::Handle m_handle;
+	T *m_address{nullptr};
+	std::size_t m_size{0};
+	std::size_t m_count{0};
+};
+
+#endif // GPUHEAP_H
@@ -33,6 +33,10 @@ public:
 	virtual ~GxmShader(void);
 	
 	bool loadFromBuffer(const char *data, std::size_t size);
+
+	// use the program in place without taking a copy. the caller guarantees
+	// the data outlives this shader, ie. it is embedded in the executable
+	bool loadFromStaticBuffer(const char *data, std::size_t size);
 	
 	bool valid(void) const;
 	Type type(void) const;
@@ -60,10 +64,12 @@ protected:
 
 private:
 	void setUniform(UniformIndex index, unsigned int offset, unsigned int count, const float *data);
+	void releaseProgram(void);
 
 private:
 	void *m_uniformBuffer{nullptr};
 	SceGxmProgram *m_shaderProgram{nullptr};
+	bool m_ownsProgram{false};
 	bool m_valid{false};
 };
 
@@ -12,6 +12,7 @@
 
 #include <framework/gpumemoryblock.h>
 
+#include <functional>
 #include <memory>
 #include <cstdint>
 
@@ -54,9 +55,20 @@ public:
 	enum TextureFormat
 	{
 		ARGB8,
-		U8_R111 // set U8 as alpha channel and BGR to 111
+		U8_R111, // set U8 as alpha channel and BGR to 111
+		UBC1, // 4x4 blocks of 4 bits per pixel, 1 bit alpha. swizzled only
+		UBC3 // 4x4 blocks of 8 bits per pixel, interpolated alpha. swizzled only
 	};
 
+	enum class Layout
+	{
+		Linear,
+		Swizzled
+	};
+
+	// fills the texture storage in place. rows are stride bytes apart
+	using DataWriter = std::function<void(char *data, std::size_t stride)>;
+
 public:
 	GxmTexture(void);
 	~GxmTexture(void) = default;
@@ -70,6 +82,9 @@ public:
 	std::size_t width(void) const { return m_width; }
 	std::size_t height(void) const { return m_height; }
 	std::size_t depth(void) const { return m_depth; }
+	// bytes per row of pixels, or per row of blocks for compressed formats
+	std::size_t stride(void) const;
+	std::size_t storageSize(void) const;
 
 	void setMinificationFilter(Filter filter);
 	void setMagnificationFilter(Filter filter);
@@ -78,9 +93,16 @@ public:
 	void setWrapMode(WrapMode mode);
 
 	void setFormat(TextureFormat format);
+	void setLayout(Layout layout);
 
 	void setData(const void *data);
 	void setEmptyData(void);
+	void writeData(const DataWriter& writer);
+
+	// copies a rectangle of pixels, or of whole blocks for compressed
+	// formats, into a linear texture that already has its data. rows of data
+	// are stride bytes apart. rows as wide as the texture go in one copy
+	void updateRegion(std::size_t x, std::size_t y, std::size_t width, std::size_t height, const void *data, std::size_t stride);
 
 protected:
 	char *storage(void) const;
@@ -92,6 +114,7 @@ private:
 	std::size_t m_height{1};
 	std::size_t m_depth{1};
 	TextureFormat m_format;
+	Layout m_layout{Layout::Linear};
 };
 
 #endif //GXMTEXTURE_H
@@ -0,0 +1,108 @@
+/*
+ * heapallocator.h - two level segregated fit allocator
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef HEAPALLOCATOR_H
+#define HEAPALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// hands out ranges of address space given to it with addRegion, in constant
+// time. it never touches the memory itself and keeps its bookkeeping to one
+// side, which suits uncached gpu memory, and leaves nothing vita specific to
+// build it against. allocations are rounded to GRANULARITY, which is also
+// their alignment
+class HeapAllocator
+{
+public:
+	using Handle = std::uint32_t;
+
+	static constexpr Handle INVALID_HANDLE = ~0u;
+	static constexpr std::size_t GRANULARITY = 16;
+
+	struct Statistics
+	{
+		std::size_t totalBytes;
+		std::size_t usedBytes;
+		std::size_t freeBytes;
+		std::size_t largestFreeBlock;
+		unsigned int allocations;
+		unsigned int freeBlocks;
+		unsigned int regions;
+
+		// the share of free space outside the largest free block. zero when
+		// it is all in one piece
+		float fragmentation;
+	};
+
+public:
+	HeapAllocator(void);
+
+	// the address and size must be multiples of GRANULARITY
+	void addRegion(std::uintptr_t address, std::size_t size);
+
+	// INVALID_HANDLE when no free block is large enough
+	Handle allocate(std::size_t size);
+	void free(Handle handle);
+
+	std::uintptr_t address(Handle handle) const;
+	std::size_t size(Handle handle) const;
+
+	Statistics statistics(void) const;
+
+private:
+	static constexpr unsigned int GRANULARITY_LOG2 = 4;
+	static constexpr unsigned int SECOND_LEVEL_LOG2 = 4;
+	static constexpr unsigned int SECOND_LEVEL_COUNT = 1 << SECOND_LEVEL_LOG2;
+	static constexpr unsigned int FIRST_LEVEL_SHIFT = SECOND_LEVEL_LOG2 + GRANULARITY_LOG2;
+	static constexpr unsigned int FIRST_LEVEL_COUNT = 32 - FIRST_LEVEL_SHIFT + 1;
+
+	static_assert(GRANULARITY == 1 << GRANULARITY_LOG2, "granularity must match its log2");
+
+	// a block is either free and on a size class list, or allocated. its
+	// physical neighbours are linked so freeing can merge them
+	struct Block
+	{
+		std::uintptr_t address;
+		std::size_t size;
+		Handle prevPhysical;
+		Handle nextPhysical;
+		Handle prevFree;
+		Handle nextFree;
+		bool free;
+	};
+
+private:
+	static void mapping(std::size_t size, unsigned int *fl, unsigned int *sl);
+
+	Handle newBlock(std::uintptr_t address, std::size_t size);
+	void releaseBlock(Handle handle);
+
+	Handle findFree(std::size_t size) const;
+	void insertFree(Handle handle);
+	void removeFree(Handle handle);
+	void merge(Handle handle, Handle next);
+
+private:
+	std::vector<Block> m_blocks;
+	std::vector<Handle> m_unusedBlocks;
+
+	std::uint32_t m_firstLevel{0};
+	std::uint32_t m_secondLevel[FIRST_LEVEL_COUNT];
+	Handle m_freeLists[FIRST_LEVEL_COUNT][SECOND_LEVEL_COUNT];
+
+	std::size_t m_totalBytes{0};
+	std::size_t m_usedBytes{0};
+	unsigned int m_allocations{0};
+	unsigned int m_freeBlocks{0};
+	unsigned int m_regions{0};
+};
+
+#endif // HEAPALLOCATOR_H
@@ -53,7 +53,7 @@ public:
 		
 		if (m_uid < 0)
 		{
-			LOG(FATAL) << "MemoryBlock allocate failure: " << m_uid << ". sceKernelAllocMemBlock(\"\", " << type << ", " << m_size << ", " << (unsigned int)popt << ")";
+			LOG(FATAL) << "MemoryBlock allocate failure: " << m_uid << ". sceKernelAllocMemBlock(\"\", " << type << ", " << m_size << ", " << static_cast<void *>(popt) << ")";
 			return;
 		}
 		
@@ -61,7 +61,7 @@ public:
 		
 		if (res < 0)
 		{
-			LOG(FATAL) << "MemoryBlock get block failure: " << m_uid << ". sceKernelGetMemBlockBase(" << m_uid << ", " << (unsigned int)reinterpret_cast<void **>(&m_address) << ")";
+			LOG(FATAL) << "MemoryBlock get block failure: " << m_uid << ". sceKernelGetMemBlockBase(" << m_uid << ", " << static_cast<void *>(&m_address) << ")";
 			return;
 		}
 	}
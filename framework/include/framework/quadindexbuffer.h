@@ -0,0 +1,46 @@
+/*
+ * quadindexbuffer.h - one index buffer for every quad
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef QUADINDEXBUFFER_H
+#define QUADINDEXBUFFER_H
+
+#include <framework/gpumemoryblock.h>
+
+#include <cstdint>
+
+struct SceGxmContext;
+
+// quads are four vertices in the order bottom left, bottom right, top left,
+// top right. every quad is drawn with the same two triangles, so the indices
+// are written once at startup and shared instead of each geometry keeping
+// its own copy. quads that follow each other in a vertex stream are drawn
+// with a single call
+class QuadIndexBuffer
+{
+public:
+	// as many quads as 16 bit indices can reach
+	static constexpr std::size_t MAX_QUADS = 65536/4;
+	static constexpr std::size_t INDICES_PER_QUAD = 6;
+
+public:
+	static QuadIndexBuffer *instance(void);
+
+	const uint16_t *indices(void) const;
+
+	// draw quads [first, first+count) of the bound vertex stream
+	void draw(SceGxmContext *ctx, std::size_t first, std::size_t count) const;
+
+private:
+	QuadIndexBuffer(void);
+
+private:
+	GpuMemoryBlock<uint16_t> m_indices;
+};
+
+#endif // QUADINDEXBUFFER_H
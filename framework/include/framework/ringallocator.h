@@ -0,0 +1,78 @@
+/*
+ * ringallocator.h - bump allocation shared by frames in flight
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef RINGALLOCATOR_H
+#define RINGALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// hands out offsets in to a ring of memory, a fixed number of frames at a
+// time. each frame bumps from where the last one stopped and everything it
+// took is given back at once when it is retired. frames are retired in the
+// order they were begun, and a frame slot must be retired before it is begun
+// again. like HeapAllocator it only does the bookkeeping, so it builds
+// anywhere
+class RingAllocator
+{
+public:
+	static constexpr std::size_t INVALID_OFFSET = ~static_cast<std::size_t>(0);
+
+	struct Statistics
+	{
+		std::size_t size;
+		std::size_t usedBytes;
+		std::size_t frameBytes;
+		std::size_t peakFrameBytes;
+		unsigned int failures;
+	};
+
+public:
+	RingAllocator(std::size_t size, unsigned int frames);
+
+	// the slot of the frame being built, and the one beginFrame moves to
+	unsigned int frame(void) const;
+	unsigned int nextFrame(void) const;
+	bool pending(unsigned int frame) const;
+
+	void beginFrame(void);
+	void endFrame(void);
+	void retire(unsigned int frame);
+
+	// alignment is a power of two that divides the ring size. an
+	// allocation is never split across the end of the ring. INVALID_OFFSET
+	// when the frames in flight leave no room
+	std::size_t allocate(std::size_t size, std::size_t alignment);
+
+	Statistics statistics(void) const;
+
+private:
+	struct Frame
+	{
+		std::uint64_t end;
+		bool pending;
+	};
+
+private:
+	// positions only ever increase, the offset in to the ring is the
+	// position modulo its size
+	std::size_t m_size;
+	std::uint64_t m_head{0};
+	std::uint64_t m_tail{0};
+	std::uint64_t m_frameStart{0};
+
+	std::vector<Frame> m_frames;
+	unsigned int m_frame;
+
+	std::size_t m_peakFrameBytes{0};
+	unsigned int m_failures{0};
+};
+
+#endif // RINGALLOCATOR_H
@@ -17,6 +17,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <future>
 
 namespace ctpl
 {
@@ -33,6 +34,27 @@ public:
 
 	void add(TaskPtr task);
 
+	// run a functor straight on the thread pool, bypassing the ordered task
+	// queue. intended for independent work such as loading resources
+	template <typename F>
+	auto async(F&& functor) -> std::future<decltype(functor())>
+	{
+		using Result = decltype(functor());
+
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(functor));
+		auto future = task->get_future();
+
+		push([task](void)
+		{
+			(*task)();
+		});
+
+		return future;
+	}
+
+	// process-wide scheduler for work that isn't tied to a frame
+	static TaskScheduler *background(void);
+
 private:
 	using TaskInfo = struct
 	{
@@ -47,6 +69,7 @@ private:
 	void queueTask(TaskInfoPtr taskInfo, TaskPtr task);
 	void scheduleSubtasks(TaskInfoPtr taskInfo, TaskPtr task);
 	void schedule(TaskInfoPtr task);
+	void push(TaskFunctor functor);
 
 private:
 	std::unique_ptr<ctpl::thread_pool> m_threadPool;
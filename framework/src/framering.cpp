@@ -0,0 +1,96 @@
+/*
+ * framering.cpp - gpu memory that lasts one frame
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/framering.h>
+
+#include <easyloggingpp/easylogging++.h>
+
+FrameRing::FrameRing(void)
+	: m_memory(SIZE, SCE_GXM_MEMORY_ATTRIB_READ)
+	, m_ring(m_memory.size(), FRAMES)
+{
+	// the gpu writes the value of a frame's fence here once it is done
+	auto region = sceGxmGetNotificationRegion();
+
+	for (auto i = 0u; i < FRAMES; ++i)
+	{
+		m_notifications[i].address = region + i;
+		m_notifications[i].value = 0;
+		*m_notifications[i].address = 0;
+	}
+}
+
+FrameRing *FrameRing::instance(void)
+{
+	static FrameRing ring;
+	return &ring;
+}
+
+void FrameRing::beginFrame(void)
+{
+	auto frame = m_ring.nextFrame();
+
+	if (m_ring.pending(frame))
+	{
+		sceGxmNotificationWait(&m_notifications[frame]);
+		m_ring.retire(frame);
+	}
+
+	// along with anything released while the slot was last in use. the gpu
+	// finishes frames in order, so the ones before it are done as well
+	m_released[frame].clear();
+	m_ring.beginFrame();
+}
+
+void FrameRing::waitIdle(void)
+{
+	// oldest first, the order the gpu finishes them in. the frame being
+	// built is not pending until it ends
+	for (auto i = 1u; i <= FRAMES; ++i)
+	{
+		auto frame = (m_ring.frame() + i) % FRAMES;
+
+		if (!m_ring.pending(frame))
+			continue;
+
+		sceGxmNotificationWait(&m_notifications[frame]);
+		m_ring.retire(frame);
+		m_released[frame].clear();
+	}
+}
+
+const SceGxmNotification *FrameRing::endFrame(void)
+{
+	auto frame = m_ring.frame();
+	m_ring.endFrame();
+
+	// a new value each frame, so the wait cannot be satisfied by the last
+	// time this slot was used
+	m_notifications[frame].value = ++m_fence;
+	return &m_notifications[frame];
+}
+
+void *FrameRing::allocate(std::size_t size)
+{
+	auto offset = m_ring.allocate(size, ALIGNMENT);
+
+	if (offset == RingAllocator::INVALID_OFFSET)
+	{
+		auto statistics = m_ring.statistics();
+		LOG(FATAL) << "FrameRing allocate failure: " << size << " bytes, " << statistics.frameBytes << " used this frame of " << statistics.size;
+		return nullptr;
+	}
+
+	return m_memory.address() + offset;
+}
+
+RingAllocator::Statistics FrameRing::statistics(void) const
+{
+	return m_ring.statistics();
+}
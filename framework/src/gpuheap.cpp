@@ -0,0 +1,82 @@
+/*
+ * gpuheap.cpp - small gpu buffers carved from a few mapped blocks
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/gpuheap.h>
+#include <framework/bitwise.h>
+
+#include <easyloggingpp/easylogging++.h>
+
+#include <algorithm>
+
+GpuHeap *GpuHeap::instance(void)
+{
+	static GpuHeap heap;
+	return &heap;
+}
+
+GpuHeap::Handle GpuHeap::allocate(std::size_t size)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto handle = m_allocator.allocate(size);
+
+	if (handle == HeapAllocator::INVALID_HANDLE)
+	{
+		grow(size);
+		handle = m_allocator.allocate(size);
+	}
+
+	if (handle == HeapAllocator::INVALID_HANDLE)
+	{
+		LOG(FATAL) << "GpuHeap allocate failure: " << size << " bytes";
+	}
+
+	return handle;
+}
+
+void GpuHeap::free(Handle handle)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_allocator.free(handle);
+}
+
+void *GpuHeap::address(Handle handle) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return reinterpret_cast<void *>(m_allocator.address(handle));
+}
+
+std::size_t GpuHeap::size(Handle handle) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_allocator.size(handle);
+}
+
+GpuHeap::Statistics GpuHeap::statistics(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_allocator.statistics();
+}
+
+void GpuHeap::grow(std::size_t size)
+{
+	// anything larger than a region gets one only as large as it, rounded
+	// to the allocator's granularity. that is on the list its size falls
+	// on, where the allocator finds it without rounding the size up
+	size = alignPow2(size, HeapAllocator::GRANULARITY);
+
+	auto region = std::make_unique<GpuMemoryBlock<char>>
+	(
+		std::max(size, REGION_SIZE),
+		SCE_GXM_MEMORY_ATTRIB_READ
+	);
+
+	// the block is page aligned and a whole number of pages
+	m_allocator.addRegion(reinterpret_cast<std::uintptr_t>(region->address()), region->size());
+	m_regions.push_back(std::move(region));
+}
@@ -34,8 +34,7 @@ namespace
 
 GxmShader::~GxmShader(void)
 {
-	if (m_shaderProgram)
-		delete[] reinterpret_cast<unsigned char *>(m_shaderProgram);
+	releaseProgram();
 }
 
 bool GxmShader::loadFromBuffer(const char *shader, std::size_t size)
@@ -49,10 +48,26 @@ bool GxmShader::loadFromBuffer(const char *shader, std::size_t size)
 		return false;
 	}
 	
-	if (m_shaderProgram)
-		delete[] reinterpret_cast<char *>(m_shaderProgram);
+	releaseProgram();
 
 	m_shaderProgram = reinterpret_cast<SceGxmProgram *>(program);
+	m_ownsProgram = true;
+	m_valid = true;
+	return true;
+}
+
+bool GxmShader::loadFromStaticBuffer(const char *shader, std::size_t size)
+{
+	if (!analyseShader(shader))
+	{
+		return false;
+	}
+
+	releaseProgram();
+
+	// gxm only ever reads the program so it is safe to drop the const here
+	m_shaderProgram = reinterpret_cast<SceGxmProgram *>(const_cast<char *>(shader));
+	m_ownsProgram = false;
 	m_valid = true;
 	return true;
 }
@@ -110,6 +125,15 @@ void GxmShader::setUniform(GxmShader::UniformIndex index, unsigned int offset, u
 	sceGxmSetUniformDataF(m_uniformBuffer, index, offset, count, data);
 }
 
+void GxmShader::releaseProgram(void)
+{
+	if (m_shaderProgram && m_ownsProgram)
+		delete[] reinterpret_cast<char *>(m_shaderProgram);
+
+	m_shaderProgram = nullptr;
+	m_ownsProgram = false;
+}
+
 bool GxmShader::analyseShader(const char *shader)
 {
 	auto program = reinterpret_cast<const SceGxmProgram *>(shader);
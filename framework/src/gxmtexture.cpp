@@ -73,10 +73,29 @@ namespace
 			return SCE_GXM_TEXTURE_FORMAT_A8R8G8B8;
 		case GxmTexture::U8_R111:
 			return SCE_GXM_TEXTURE_FORMAT_U8_R111;
+		case GxmTexture::UBC1:
+			return SCE_GXM_TEXTURE_FORMAT_UBC1_ABGR;
+		case GxmTexture::UBC3:
+			return SCE_GXM_TEXTURE_FORMAT_UBC3_ABGR;
 		}
 	}
 
-	constexpr std::size_t texturePixelSize(GxmTexture::TextureFormat format)
+	// width and height of the smallest addressable unit of a format
+	constexpr std::size_t textureBlockSize(GxmTexture::TextureFormat format)
+	{
+		switch (format)
+		{
+		default:
+		case GxmTexture::ARGB8:
+		case GxmTexture::U8_R111:
+			return 1;
+		case GxmTexture::UBC1:
+		case GxmTexture::UBC3:
+			return 4;
+		}
+	}
+
+	constexpr std::size_t textureBlockBytes(GxmTexture::TextureFormat format)
 	{
 		switch (format)
 		{
@@ -85,6 +104,10 @@ namespace
 			return 4;
 		case GxmTexture::U8_R111:
 			return 1;
+		case GxmTexture::UBC1:
+			return 8;
+		case GxmTexture::UBC3:
+			return 16;
 		}
 	}
 } // anonymous namespace
@@ -102,7 +125,7 @@ void GxmTexture::allocateStorage(void)
 
 	m_storage = std::make_unique<GpuMemoryBlock<char>>
 	(
-		  m_width*m_height*m_depth*texturePixelSize(m_format)
+		  storageSize()
 		, SCE_GXM_MEMORY_ATTRIB_READ
 		, SCE_KERNEL_MEMBLOCK_TYPE_USER_CDRAM_RW
 	);
@@ -118,6 +141,18 @@ void GxmTexture::bind(SceGxmContext *ctx, std::uint32_t unit) const
 	sceGxmSetFragmentTexture(ctx, unit, m_texture.get());
 }
 
+std::size_t GxmTexture::stride(void) const
+{
+	auto block = textureBlockSize(m_format);
+	return (m_width+block-1)/block*textureBlockBytes(m_format);
+}
+
+std::size_t GxmTexture::storageSize(void) const
+{
+	auto block = textureBlockSize(m_format);
+	return stride()*((m_height+block-1)/block)*m_depth;
+}
+
 void GxmTexture::setSize(std::size_t width, std::size_t height, std::size_t depth)
 {
 	m_width = width;
@@ -127,13 +162,37 @@ void GxmTexture::setSize(std::size_t width, std::size_t height, std::size_t dept
 
 void GxmTexture::setData(const void *data)
 {
-	if (data == nullptr)
+	writeData([this, data](char *storage, std::size_t)
 	{
-		std::memset(m_storage->address(), 0, m_width*m_height*m_depth*texturePixelSize(m_format));
-	}
-	else
+		if (data == nullptr)
+		{
+			std::memset(storage, 0, storageSize());
+		}
+		else
+		{
+			std::memcpy(storage, data, storageSize());
+		}
+	});
+}
+
+void GxmTexture::writeData(const DataWriter& writer)
+{
+	writer(m_storage->address(), stride());
+
+	if (m_layout == Layout::Swizzled)
 	{
-		std::memcpy(m_storage->address(), data, m_width*m_height*m_depth*texturePixelSize(m_format));
+		auto res = sceGxmTextureInitSwizzled
+		(
+			m_texture.get(), 
+			m_storage->address(), 
+			convertTextureFormat(m_format),
+			m_width,
+			m_height,
+			0
+		);
+
+		LOG(INFO) << "sceGxmTextureInitSwizzled: " << res;
+		return;
 	}
 
 	auto res = sceGxmTextureInitLinear
@@ -149,6 +208,32 @@ void GxmTexture::setData(const void *data)
 	LOG(INFO) << "sceGxmTextureInitLinear: " << res;
 }
 
+void GxmTexture::updateRegion(std::size_t x, std::size_t y, std::size_t width, std::size_t height, const void *data, std::size_t stride)
+{
+	if (m_layout == Layout::Swizzled)
+	{
+		LOG(FATAL) << "updateRegion: swizzled textures can only be written whole";
+		return;
+	}
+
+	auto block = textureBlockSize(m_format);
+	auto rowBytes = (width+block-1)/block*textureBlockBytes(m_format);
+	auto rows = (height+block-1)/block;
+	auto source = static_cast<const char *>(data);
+	auto destination = m_storage->address() + (y/block)*this->stride() + (x/block)*textureBlockBytes(m_format);
+
+	if (rowBytes == this->stride() && stride == rowBytes)
+	{
+		std::memcpy(destination, source, rowBytes*rows);
+		return;
+	}
+
+	for (auto i = 0u; i < rows; ++i)
+	{
+		std::memcpy(destination + i*this->stride(), source + i*stride, rowBytes);
+	}
+}
+
 void GxmTexture::setEmptyData(void)
 {
 	setData(nullptr);
@@ -193,6 +278,11 @@ void GxmTexture::setFormat(TextureFormat format)
 	m_format = format;
 }
 
+void GxmTexture::setLayout(Layout layout)
+{
+	m_layout = layout;
+}
+
 char *GxmTexture::storage(void) const
 {
 	return m_storage->address();
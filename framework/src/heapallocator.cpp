@@ -0,0 +1,307 @@
+/*
+ * heapallocator.cpp - two level segregated fit allocator
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/heapallocator.h>
+#include <framework/bitwise.h>
+
+#include <algorithm>
+
+namespace
+{
+	unsigned int highestBit(std::uint32_t value)
+	{
+		return 31 - __builtin_clz(value);
+	}
+
+	unsigned int lowestBit(std::uint32_t value)
+	{
+		return __builtin_ctz(value);
+	}
+} // anonymous namespace
+
+HeapAllocator::HeapAllocator(void)
+{
+	std::fill(std::begin(m_secondLevel), std::end(m_secondLevel), 0);
+
+	for (auto& list : m_freeLists)
+	{
+		std::fill(std::begin(list), std::end(list), INVALID_HANDLE);
+	}
+}
+
+void HeapAllocator::addRegion(std::uintptr_t address, std::size_t size)
+{
+	auto handle = newBlock(address, size);
+	insertFree(handle);
+
+	m_totalBytes += size;
+	++m_regions;
+}
+
+HeapAllocator::Handle HeapAllocator::allocate(std::size_t size)
+{
+	size = alignPow2(std::max<std::size_t>(size, 1), GRANULARITY);
+
+	auto handle = findFree(size);
+
+	if (handle == INVALID_HANDLE)
+		return INVALID_HANDLE;
+
+	removeFree(handle);
+
+	// give back whatever we do not need. the record is created before
+	// taking a reference, the vector may move
+	auto remaining = m_blocks[handle].size - size;
+
+	if (remaining >= GRANULARITY)
+	{
+		auto rest = newBlock(m_blocks[handle].address + size, remaining);
+		auto next = m_blocks[handle].nextPhysical;
+
+		m_blocks[rest].prevPhysical = handle;
+		m_blocks[rest].nextPhysical = next;
+
+		if (next != INVALID_HANDLE)
+		{
+			m_blocks[next].prevPhysical = rest;
+		}
+
+		m_blocks[handle].nextPhysical = rest;
+		m_blocks[handle].size = size;
+		insertFree(rest);
+	}
+
+	m_blocks[handle].free = false;
+	m_usedBytes += m_blocks[handle].size;
+	++m_allocations;
+	return handle;
+}
+
+void HeapAllocator::free(Handle handle)
+{
+	if (handle == INVALID_HANDLE)
+		return;
+
+	m_blocks[handle].free = true;
+	m_usedBytes -= m_blocks[handle].size;
+	--m_allocations;
+
+	// merge with free neighbours so the space can be handed out whole again
+	auto next = m_blocks[handle].nextPhysical;
+
+	if (next != INVALID_HANDLE && m_blocks[next].free)
+	{
+		removeFree(next);
+		merge(handle, next);
+	}
+
+	auto prev = m_blocks[handle].prevPhysical;
+
+	if (prev != INVALID_HANDLE && m_blocks[prev].free)
+	{
+		removeFree(prev);
+		merge(prev, handle);
+		handle = prev;
+	}
+
+	insertFree(handle);
+}
+
+std::uintptr_t HeapAllocator::address(Handle handle) const
+{
+	return m_blocks[handle].address;
+}
+
+std::size_t HeapAllocator::size(Handle handle) const
+{
+	return m_blocks[handle].size;
+}
+
+HeapAllocator::Statistics HeapAllocator::statistics(void) const
+{
+	Statistics statistics;
+	statistics.totalBytes = m_totalBytes;
+	statistics.usedBytes = m_usedBytes;
+	statistics.freeBytes = m_totalBytes - m_usedBytes;
+	statistics.largestFreeBlock = 0;
+	statistics.allocations = m_allocations;
+	statistics.freeBlocks = m_freeBlocks;
+	statistics.regions = m_regions;
+	statistics.fragmentation = 0.f;
+
+	if (!m_firstLevel)
+		return statistics;
+
+	// the largest block is on the highest list in use, but not necessarily
+	// first on it
+	auto fl = highestBit(m_firstLevel);
+	auto sl = highestBit(m_secondLevel[fl]);
+
+	for (auto handle = m_freeLists[fl][sl]; handle != INVALID_HANDLE; handle = m_blocks[handle].nextFree)
+	{
+		statistics.largestFreeBlock = std::max(statistics.largestFreeBlock, m_blocks[handle].size);
+	}
+
+	statistics.fragmentation = 1.f - static_cast<float>(statistics.largestFreeBlock)/statistics.freeBytes;
+	return statistics;
+}
+
+void HeapAllocator::mapping(std::size_t size, unsigned int *fl, unsigned int *sl)
+{
+	// small sizes get a list each, the rest are split in to
+	// SECOND_LEVEL_COUNT lists per power of two
+	if (size < (1u << FIRST_LEVEL_SHIFT))
+	{
+		*fl = 0;
+		*sl = size >> GRANULARITY_LOG2;
+		return;
+	}
+
+	auto msb = highestBit(size);
+	*sl = (size >> (msb - SECOND_LEVEL_LOG2)) ^ SECOND_LEVEL_COUNT;
+	*fl = msb - (FIRST_LEVEL_SHIFT - 1);
+}
+
+HeapAllocator::Handle HeapAllocator::newBlock(std::uintptr_t address, std::size_t size)
+{
+	Block block = { address, size, INVALID_HANDLE, INVALID_HANDLE, INVALID_HANDLE, INVALID_HANDLE, true };
+
+	if (m_unusedBlocks.empty())
+	{
+		m_blocks.push_back(block);
+		return m_blocks.size()-1;
+	}
+
+	auto handle = m_unusedBlocks.back();
+	m_unusedBlocks.pop_back();
+	m_blocks[handle] = block;
+	return handle;
+}
+
+void HeapAllocator::releaseBlock(Handle handle)
+{
+	m_unusedBlocks.push_back(handle);
+}
+
+HeapAllocator::Handle HeapAllocator::findFree(std::size_t size) const
+{
+	// round up to the next list, so any block on it or above is large
+	// enough without searching
+	auto rounded = size;
+
+	if (size >= (1u << FIRST_LEVEL_SHIFT))
+	{
+		rounded += (1u << (highestBit(size) - SECOND_LEVEL_LOG2)) - 1;
+	}
+
+	unsigned int fl, sl;
+	mapping(rounded, &fl, &sl);
+
+	if (fl < FIRST_LEVEL_COUNT)
+	{
+		auto lists = m_secondLevel[fl] & (~0u << sl);
+
+		if (!lists)
+		{
+			auto levels = (fl+1 < 32) ? m_firstLevel & (~0u << (fl+1)) : 0;
+			fl = levels ? lowestBit(levels) : FIRST_LEVEL_COUNT;
+			lists = levels ? m_secondLevel[fl] : 0;
+		}
+
+		if (lists)
+			return m_freeLists[fl][lowestBit(lists)];
+	}
+
+	// nothing above, but the list the size itself falls on may still hold
+	// a block large enough. a region made for one large allocation is only
+	// ever on that list
+	mapping(size, &fl, &sl);
+
+	if (fl >= FIRST_LEVEL_COUNT)
+		return INVALID_HANDLE;
+
+	for (auto handle = m_freeLists[fl][sl]; handle != INVALID_HANDLE; handle = m_blocks[handle].nextFree)
+	{
+		if (m_blocks[handle].size >= size)
+			return handle;
+	}
+
+	return INVALID_HANDLE;
+}
+
+void HeapAllocator::insertFree(Handle handle)
+{
+	unsigned int fl, sl;
+	mapping(m_blocks[handle].size, &fl, &sl);
+
+	auto head = m_freeLists[fl][sl];
+	m_blocks[handle].free = true;
+	m_blocks[handle].prevFree = INVALID_HANDLE;
+	m_blocks[handle].nextFree = head;
+
+	if (head != INVALID_HANDLE)
+	{
+		m_blocks[head].prevFree = handle;
+	}
+
+	m_freeLists[fl][sl] = handle;
+	m_firstLevel |= 1u << fl;
+	m_secondLevel[fl] |= 1u << sl;
+	++m_freeBlocks;
+}
+
+void HeapAllocator::removeFree(Handle handle)
+{
+	unsigned int fl, sl;
+	mapping(m_blocks[handle].size, &fl, &sl);
+
+	auto prev = m_blocks[handle].prevFree;
+	auto next = m_blocks[handle].nextFree;
+
+	if (prev != INVALID_HANDLE)
+	{
+		m_blocks[prev].nextFree = next;
+	}
+	else
+	{
+		m_freeLists[fl][sl] = next;
+	}
+
+	if (next != INVALID_HANDLE)
+	{
+		m_blocks[next].prevFree = prev;
+	}
+
+	if (m_freeLists[fl][sl] == INVALID_HANDLE)
+	{
+		m_secondLevel[fl] &= ~(1u << sl);
+
+		if (!m_secondLevel[fl])
+		{
+			m_firstLevel &= ~(1u << fl);
+		}
+	}
+
+	--m_freeBlocks;
+}
+
+void HeapAllocator::merge(Handle handle, Handle next)
+{
+	auto after = m_blocks[next].nextPhysical;
+
+	m_blocks[handle].size += m_blocks[next].size;
+	m_blocks[handle].nextPhysical = after;
+
+	if (after != INVALID_HANDLE)
+	{
+		m_blocks[after].prevPhysical = handle;
+	}
+
+	releaseBlock(next);
+}
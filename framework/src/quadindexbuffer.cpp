@@ -0,0 +1,55 @@
+/*
+ * quadindexbuffer.cpp - one index buffer for every quad
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/quadindexbuffer.h>
+
+#include <easyloggingpp/easylogging++.h>
+
+#include <psp2/gxm.h>
+
+QuadIndexBuffer::QuadIndexBuffer(void)
+	: m_indices(MAX_QUADS*INDICES_PER_QUAD, SCE_GXM_MEMORY_ATTRIB_READ)
+{
+	auto indices = m_indices.address();
+
+	for (auto i = 0u; i < MAX_QUADS; ++i)
+	{
+		auto vertex = i*4;
+
+		indices[0] = vertex+0;
+		indices[1] = vertex+1;
+		indices[2] = vertex+2;
+		indices[3] = vertex+1;
+		indices[4] = vertex+3;
+		indices[5] = vertex+2;
+		indices += INDICES_PER_QUAD;
+	}
+}
+
+QuadIndexBuffer *QuadIndexBuffer::instance(void)
+{
+	static QuadIndexBuffer buffer;
+	return &buffer;
+}
+
+const uint16_t *QuadIndexBuffer::indices(void) const
+{
+	return m_indices.address();
+}
+
+void QuadIndexBuffer::draw(SceGxmContext *ctx, std::size_t first, std::size_t count) const
+{
+	if (first + count > MAX_QUADS)
+	{
+		LOG(FATAL) << "QuadIndexBuffer draw out of range: " << count << " quads from " << first;
+		return;
+	}
+
+	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, indices() + first*INDICES_PER_QUAD, count*INDICES_PER_QUAD);
+}
@@ -0,0 +1,91 @@
+/*
+ * ringallocator.cpp - bump allocation shared by frames in flight
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/ringallocator.h>
+
+#include <algorithm>
+
+RingAllocator::RingAllocator(std::size_t size, unsigned int frames)
+	: m_size(size)
+	, m_frames(frames, { 0, false })
+	, m_frame(frames-1)
+{
+}
+
+unsigned int RingAllocator::frame(void) const
+{
+	return m_frame;
+}
+
+unsigned int RingAllocator::nextFrame(void) const
+{
+	return (m_frame + 1) % m_frames.size();
+}
+
+bool RingAllocator::pending(unsigned int frame) const
+{
+	return m_frames[frame].pending;
+}
+
+void RingAllocator::beginFrame(void)
+{
+	m_frame = nextFrame();
+	m_frameStart = m_head;
+}
+
+void RingAllocator::endFrame(void)
+{
+	m_frames[m_frame].end = m_head;
+	m_frames[m_frame].pending = true;
+}
+
+void RingAllocator::retire(unsigned int frame)
+{
+	if (!m_frames[frame].pending)
+		return;
+
+	m_tail = std::max(m_tail, m_frames[frame].end);
+	m_frames[frame].pending = false;
+}
+
+std::size_t RingAllocator::allocate(std::size_t size, std::size_t alignment)
+{
+	auto mask = static_cast<std::uint64_t>(alignment) - 1;
+	auto start = (m_head + mask) & ~mask;
+	auto offset = start % m_size;
+
+	// skip the end of the ring rather than wrap an allocation around it.
+	// the space comes back with this frame
+	if (offset + size > m_size)
+	{
+		start += m_size - offset;
+		offset = 0;
+	}
+
+	if (size > m_size || start + size - m_tail > m_size)
+	{
+		++m_failures;
+		return INVALID_OFFSET;
+	}
+
+	m_head = start + size;
+	m_peakFrameBytes = std::max<std::size_t>(m_peakFrameBytes, m_head - m_frameStart);
+	return offset;
+}
+
+RingAllocator::Statistics RingAllocator::statistics(void) const
+{
+	Statistics statistics;
+	statistics.size = m_size;
+	statistics.usedBytes = m_head - m_tail;
+	statistics.frameBytes = m_head - m_frameStart;
+	statistics.peakFrameBytes = m_peakFrameBytes;
+	statistics.failures = m_failures;
+	return statistics;
+}
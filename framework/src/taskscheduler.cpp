@@ -32,6 +32,12 @@ TaskScheduler::~TaskScheduler(void)
 	m_schedulerThread.join();
 }
 
+TaskScheduler *TaskScheduler::background(void)
+{
+	static TaskScheduler scheduler;
+	return &scheduler;
+}
+
 void TaskScheduler::add(TaskPtr task)
 {
 	auto info = std::make_shared<TaskInfo>();
@@ -110,3 +116,11 @@ void TaskScheduler::schedule(TaskInfoPtr task)
 {
 	queueTask(task, task->task);
 }
+
+void TaskScheduler::push(TaskFunctor functor)
+{
+	m_threadPool->push([functor](auto id)
+	{
+		functor();
+	});
+}
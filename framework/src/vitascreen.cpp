@@ -11,6 +11,7 @@
 #include <framework/guiapplication.h>
 #include <framework/view.h>
 #include <framework/gpumemoryblock.h>
+#include <framework/framering.h>
 #include <framework/pixeltypes.h>
 
 #include <easyloggingpp/easylogging++.h>
@@ -177,6 +178,8 @@ VitaScreen::VitaScreen(void)
 	
 	sceGxmCreateRenderTarget(&renderTargetParams, &m_renderTarget);
 	
+	static_assert(FrameRing::FRAMES == DISPLAY_QUEUE_MAX_PENDING, "the frame ring needs a slot per display buffer");
+
 	// allocate our framebuffers
 	for (int i = 0; i < DISPLAY_QUEUE_MAX_PENDING; ++i)
 	{
@@ -215,6 +218,10 @@ VitaScreen::~VitaScreen(void)
 void VitaScreen::draw(void)
 {
 	auto views = GuiApplication::allViews();
+	auto frameRing = FrameRing::instance();
+
+	// transient geometry for this frame goes where the gpu has finished
+	frameRing->beginFrame();
 	
 	sceGxmBeginScene(m_context, 
 		0, 
@@ -230,7 +237,7 @@ void VitaScreen::draw(void)
 		view->render(m_context);
 	}
 	
-	sceGxmEndScene(m_context, nullptr, nullptr);
+	sceGxmEndScene(m_context, nullptr, frameRing->endFrame());
 	sceGxmPadHeartbeat(m_fb[m_nextRenderBufferIndex]->surface(), m_fb[m_nextRenderBufferIndex]->sync());
 	
 	CallbackData data;
@@ -14,13 +14,14 @@
 #include "rectangle.h"
 #include "geometryrenderer.h"
 #include "vertextypes.h"
+#include "texturecache.h"
+
+#include <framework/framering.h>
 
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/color_space.hpp>
 #include <glm/gtx/transform.hpp>
 
-#include <png++/png.hpp>
-
 #include <easyloggingpp/easylogging++.h>
 
 #include <psp2/gxm.h>
@@ -100,14 +101,9 @@ namespace
 
 AnimatedBackground::AnimatedBackground(GxmShaderPatcher *patcher)
 	: m_renderer(patcher)
-	, m_texCoords(std::make_unique<GpuMemoryBlock<TextureCoordVertex>>
-	(
-		4,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	))
 {
 	// set our shader program
-	m_renderer.setShaders<AnimatedBackgroundVertex<TextureCoordVertex>>("rsc:/animbg.vert.cg.gxp", "rsc:/animbg.frag.cg.gxp");
+	m_renderer.setShaders<AnimatedBackgroundVertex<TextureCoordVertex>>("rsc:/animbg.vert.cg.gxp"_rsc, "rsc:/animbg.frag.cg.gxp"_rsc);
 	m_rectangle.setFragmentTask(std::bind(&AnimatedBackground::fragmentTask, this, std::placeholders::_1));
 
 	m_rectangle.setWidth(4096*4);
@@ -119,11 +115,21 @@ AnimatedBackground::AnimatedBackground(GxmShaderPatcher *patcher)
 	setColour(topLeftRgb, bottomRightRgb);
 
 	// load textures
-	loadTexture(&m_textures[0].texture, "textures/bgbase.png");
-	loadTexture(&m_textures[1].texture, "textures/bgspec1.png");
-	loadTexture(&m_textures[2].texture, "textures/bgspec2.png");
-	loadTexture(&m_textures[3].texture, "textures/bgspec3.png");
-	loadTexture(&m_textures[4].texture, "textures/bgspec4.png");
+	std::string prefix = TEXTURE_SOURCE_PREFIX;
+
+	auto textures = TextureCache::instance()->textures(
+	{
+		prefix + "textures/bgbase.rtex",
+		prefix + "textures/bgspec1.rtex",
+		prefix + "textures/bgspec2.rtex",
+		prefix + "textures/bgspec3.rtex",
+		prefix + "textures/bgspec4.rtex"
+	});
+
+	for (auto i = 0u; i < textures.size(); ++i)
+	{
+		m_textures[i].texture = textures[i];
+	}
 
 	// set movement rates etc
 	m_textures[0].position = glm::vec2(256.f, 256.f);
@@ -145,47 +151,17 @@ AnimatedBackground::AnimatedBackground(GxmShaderPatcher *patcher)
 	m_textures[4].dispModifier = glm::vec2(1, 1);
 }
 
-void AnimatedBackground::loadTexture(GxmTexture *texture, const char *file)
-{
-	class VectorStream : public std::basic_streambuf<char, std::char_traits<char>>
-	{
-	public:
-		VectorStream(std::vector<char>& v)
-		{
-			setg(v.data(), v.data(), v.data()+v.size());
-		}
-	};
-	
-	std::string prefix = TEXTURE_SOURCE_PREFIX;
-	auto fileData = Resource::read(prefix + file);
-	
-	if (!fileData.good)
-	{
-		LOG(FATAL) << "could not load texture: " << prefix << file;
-	}
-
-	VectorStream vstream(fileData.data);
-	std::istream stream(&vstream);
-	
-	png::image<png::rgba_pixel, png::solid_pixel_buffer<png::rgba_pixel>> image(stream);
-	
-	texture->setSize(image.get_width(), image.get_height());
-	texture->setFormat(GxmTexture::ARGB8);
-	texture->allocateStorage();
-	texture->setData(image.get_pixbuf().get_bytes().data());
-	texture->setMinMagFilter(GxmTexture::Linear, GxmTexture::Linear);
-	texture->setWrapMode(GxmTexture::Repeat);
-}
-
 void AnimatedBackground::fragmentTask(SceGxmContext *ctx)
 {
-	m_textures[0].texture.bind(ctx, 0);
-	m_textures[1].texture.bind(ctx, 1);
-	m_textures[2].texture.bind(ctx, 2);
-	m_textures[3].texture.bind(ctx, 3);
-	m_textures[4].texture.bind(ctx, 4);
+	m_textures[0].texture->bind(ctx, 0);
+	m_textures[1].texture->bind(ctx, 1);
+	m_textures[2].texture->bind(ctx, 2);
+	m_textures[3].texture->bind(ctx, 3);
+	m_textures[4].texture->bind(ctx, 4);
 	
-	sceGxmSetVertexStream(ctx, 1, m_texCoords->address());
+	auto texCoords = FrameRing::instance()->allocate<TextureCoordVertex>(4);
+	std::copy(std::begin(m_texCoords), std::end(m_texCoords), texCoords);
+	sceGxmSetVertexStream(ctx, 1, texCoords);
 }
 
 void AnimatedBackground::update(float dt)
@@ -206,10 +182,10 @@ void AnimatedBackground::update(float dt)
 		float dyl = tex->position.y/512.f-tileFrequency/2.f;
 		float dyu = tex->position.y/512.f+tileFrequency/2.f;
 
-		m_texCoords->address()[0].texCoord[i] = glm::vec2(dxl, dyu);
-		m_texCoords->address()[1].texCoord[i] = glm::vec2(dxu, dyu);
-		m_texCoords->address()[2].texCoord[i] = glm::vec2(dxl, dyl);
-		m_texCoords->address()[3].texCoord[i] = glm::vec2(dxu, dyl);
+		m_texCoords[0].texCoord[i] = glm::vec2(dxl, dyu);
+		m_texCoords[1].texCoord[i] = glm::vec2(dxu, dyu);
+		m_texCoords[2].texCoord[i] = glm::vec2(dxl, dyl);
+		m_texCoords[3].texCoord[i] = glm::vec2(dxu, dyl);
 	}
 }
 
@@ -10,12 +10,10 @@
 #ifndef ANIMATEDBACKGROUND_H
 #define ANIMATEDBACKGROUND_H
 
-#include <framework/gxmtexture.h>
-#include <framework/gpumemoryblock.h>
-
 #include "geometryrenderer.h"
 #include "rectangle.h"
 #include "vertextypes.h"
+#include "texturecache.h"
 
 struct SceGxmContext;
 class Camera;
@@ -43,14 +41,13 @@ private:
 
 	struct BgTexture
 	{
-		GxmTexture texture;
+		TextureCache::TexturePtr texture;
 		glm::vec2 position;
 		glm::vec2 dispRate;
 		glm::vec2 dispModifier;
 	};
 
 private:
-	void loadTexture(GxmTexture *texture, const char *file);
 	void fragmentTask(SceGxmContext *ctx);
 
 private:
@@ -58,7 +55,9 @@ private:
 	Rectangle<ColouredGeometryVertex> m_rectangle;
 	
 	BgTexture m_textures[5];
-	std::unique_ptr<GpuMemoryBlock<TextureCoordVertex>> m_texCoords;
+
+	// scrolled every update, so copied to the frame ring each draw
+	TextureCoordVertex m_texCoords[4]{};
 
 	glm::vec4 m_bottomRightColour, m_topLeftColour;
 };
@@ -10,67 +10,624 @@
 #include "characteratlas.h"
 
 #include <freetype2/ft2build.h>
-#include FT_IMAGE_H
 #include FT_FREETYPE_H
+#include FT_IMAGE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+std::atomic<unsigned int> CharacterAtlas::s_frame{0};
 
-CharacterAtlas::CharacterAtlas(void)
+namespace
 {
-	m_atlas = new TextureAtlas(512, 512);
-	m_atlas->setFormat(GxmTexture::U8_R111);
-	m_atlas->create(GxmTexture::Point, GxmTexture::Linear);
+	// offsets are from the start of the saved atlas. bitmaps are aligned so
+	// the data can be used in place
+	struct SavedAtlas
+	{
+		std::uint32_t pageSize;
+		std::uint32_t pageCount;
+		std::uint32_t glyphCount;
+		std::uint32_t glyphOffset;
+	};
+
+	// only the rows below the highest part of the skyline are saved, the
+	// rest of the page is empty
+	struct SavedPage
+	{
+		std::uint32_t rows;
+		std::uint32_t bitmapOffset;
+		std::uint32_t skylineCount;
+		std::uint32_t skylineOffset;
+	};
+
+	struct SavedNode
+	{
+		std::int32_t x, y, width;
+	};
+
+	struct SavedGlyph
+	{
+		std::uint32_t character;
+		std::uint32_t page;
+		std::int32_t x, y, width, height;
+		float advanceX, advanceY;
+		float left, top;
+	};
+
+	constexpr std::size_t SAVED_BITMAP_ALIGNMENT = 16;
+
+	bool fits(std::size_t size, std::size_t offset, std::size_t count, std::size_t element)
+	{
+		return offset <= size && count <= (size - offset)/element;
+	}
+
+	template <typename T>
+	T readSaved(const char *data, std::size_t offset)
+	{
+		T value;
+		std::memcpy(&value, data + offset, sizeof(T));
+		return value;
+	}
+
+	template <typename T>
+	void writeSaved(std::vector<char>& data, std::size_t offset, const T& value)
+	{
+		std::memcpy(data.data() + offset, &value, sizeof(T));
+	}
+
+	// the packer walks the skyline assuming it covers the page exactly
+	bool validSkyline(const TextureAtlas::Skyline& skyline, std::size_t width, std::size_t rows)
+	{
+		auto x = 1;
+
+		for (auto& node : skyline)
+		{
+			if (node.x != x || node.z <= 0 || node.y < 0 || static_cast<std::size_t>(node.y) > rows)
+				return false;
+
+			x += node.z;
+		}
+
+		return !skyline.empty() && static_cast<std::size_t>(x) == width-1;
+	}
+} // anonymous namespace
+
+constexpr std::size_t CharacterAtlas::PAGE_SIZE;
+constexpr std::size_t CharacterAtlas::DEFAULT_PAGE_BUDGET;
+constexpr unsigned int CharacterAtlas::DENSE_GLYPHS;
+constexpr unsigned int CharacterAtlas::COLD_FRAMES;
+
+CharacterAtlas::CharacterAtlas(GxmTexture::Filter minFilter, std::size_t pageBudget)
+	: m_minFilter(minFilter)
+	, m_pageBudget(std::max<std::size_t>(pageBudget, 1))
+{
+	addPage();
 }
 
 CharacterAtlas::~CharacterAtlas(void)
 {
-	delete m_atlas;
+}
+
+void CharacterAtlas::nextFrame(void)
+{
+	++s_frame;
+}
+
+bool CharacterAtlas::collect(void)
+{
+	if (!m_full)
+		return false;
+
+	m_full = false;
+
+	// every page with cold glyphs on it, so the room lasts more than a frame
+	std::vector<bool> coldPages(m_pages.size(), false);
+
+	for (auto character : characters())
+	{
+		auto data = glyph(character);
+
+		if (cold(data))
+		{
+			coldPages[data->info.page] = true;
+		}
+	}
+
+	auto moved = false;
+
+	for (auto page = 0u; page < m_pages.size(); ++page)
+	{
+		if (coldPages[page])
+		{
+			moved |= repack(page);
+		}
+	}
+
+	return moved;
 }
 
 bool CharacterAtlas::contains(unsigned int character)
 {
-	return m_glyphMap.find(character) != m_glyphMap.end();
+	return glyph(character) != nullptr;
 }
 
 bool CharacterAtlas::addGlyph(unsigned int character, const FT_GlyphSlotRec_ *glyph)
 {
 	const FT_Bitmap *bitmap = &glyph->bitmap;
 
-	// we cant easily remove characters from our atlas, so we'll just 
-	// create a new entry and throw away the old reference
-	auto region = m_atlas->region(bitmap->width, bitmap->rows);
+	return addGlyph
+	(
+		character,
+		reinterpret_cast<char *>(bitmap->buffer),
+		bitmap->width,
+		bitmap->rows,
+		bitmap->pitch,
+		glm::vec2(glyph->linearHoriAdvance >> 16, glyph->linearVertAdvance >> 16),
+		static_cast<float>(glyph->bitmap_left),
+		static_cast<float>(glyph->bitmap_top)
+	);
+}
+
+bool CharacterAtlas::addGlyph(unsigned int character, const char *bitmap, std::size_t width, std::size_t rows, std::size_t pitch, const glm::vec2& advance, float left, float top)
+{
+	TextureAtlas::AtlasRegion region;
+	unsigned int page;
 
-	// check if we successfully allocated memory within the atlas
-	if (region.x == -1 || region.y == -1)
+	// the pages are full until collect makes room, the caller gets an
+	// empty glyph
+	if (!place(width, rows, &region, &page))
 	{
 		return false;
 	}
 	
-	m_atlas->setRegion(region, reinterpret_cast<char *>(bitmap->buffer), bitmap->pitch);
-	m_glyphMap.insert({character, 
+	m_pages[page]->setRegion(region, bitmap, pitch);
+	insert(character, region, page, advance, left, top);
+	++m_rasterizations;
+	return true;
+}
+
+bool CharacterAtlas::setBakedPage(const char *bitmap, std::size_t width, std::size_t rows)
+{
+	auto page = m_pages.front().get();
+
+	if (width != page->width() || rows > page->height())
 	{
-		region, 
-		glm::vec2(glyph->linearHoriAdvance >> 16, glyph->linearVertAdvance >> 16),
-		static_cast<float>(glyph->bitmap_left),
-		static_cast<float>(glyph->bitmap_top)
-	}});
+		return false;
+	}
+
+	page->setRegion(TextureAtlas::AtlasRegion(0, 0, width+1, rows+1), bitmap, width);
+	page->reserve(rows);
 	return true;
 }
 
+void CharacterAtlas::addBakedGlyph(unsigned int character, const TextureAtlas::AtlasRegion& region, const glm::vec2& advance, float left, float top)
+{
+	insert(character, region, 0, advance, left, top);
+}
+
 CharacterAtlas::GlyphInfo CharacterAtlas::glyphInfo(unsigned int character)
 {
-	GlyphInfo info;
-	
-	if (!contains(character))
-		return info;
+	auto info = find(character);
+	return info ? *info : GlyphInfo();
+}
+
+const CharacterAtlas::GlyphInfo *CharacterAtlas::find(unsigned int character)
+{
+	auto data = glyph(character);
+
+	if (!data)
+		return nullptr;
+
+	data->lastUsed = s_frame;
+	return &data->info;
+}
+
+void CharacterAtlas::touch(unsigned int character)
+{
+	if (auto data = glyph(character))
+	{
+		data->lastUsed = s_frame;
+	}
+}
+
+unsigned int CharacterAtlas::generation(void) const
+{
+	return m_generation;
+}
+
+CharacterAtlas::Statistics CharacterAtlas::statistics(void) const
+{
+	std::size_t used = 0;
+
+	for (auto i = 0u; i < DENSE_GLYPHS; ++i)
+	{
+		if (m_denseUsed[i])
+			used += m_denseGlyphs[i].region.z*m_denseGlyphs[i].region.w;
+	}
+
+	for (auto& glyph : m_glyphMap)
+	{
+		used += glyph.second.region.z*glyph.second.region.w;
+	}
+
+	Statistics statistics;
+	statistics.pages = m_pages.size();
+	statistics.glyphs = m_denseUsed.count() + m_glyphMap.size();
+	statistics.occupancy = static_cast<float>(used)/(m_pages.size()*PAGE_SIZE*PAGE_SIZE);
+	statistics.evictions = m_evictions;
+	statistics.rasterizations = m_rasterizations;
+	statistics.uploadedBytes = uploadedBytes();
+	return statistics;
+}
+
+std::size_t CharacterAtlas::uploadedBytes(void) const
+{
+	std::size_t bytes = 0;
+
+	for (auto& page : m_pages)
+	{
+		bytes += page->uploadedBytes();
+	}
+
+	return bytes;
+}
+
+std::vector<char> CharacterAtlas::save(void) const
+{
+	std::vector<SavedGlyph> glyphs;
+
+	auto saveGlyph = [&glyphs](unsigned int character, const GlyphData& data)
+	{
+		glyphs.push_back
+		({
+			character,
+			data.info.page,
+			data.region.x, data.region.y, data.region.z, data.region.w,
+			data.info.advance.x, data.info.advance.y,
+			data.info.bitmap_left, data.info.bitmap_top
+		});
+	};
+
+	for (auto i = 0u; i < DENSE_GLYPHS; ++i)
+	{
+		if (m_denseUsed[i])
+			saveGlyph(i, m_denseGlyphs[i]);
+	}
+
+	for (auto& glyph : m_glyphMap)
+	{
+		saveGlyph(glyph.first, glyph.second);
+	}
+
+	std::vector<SavedPage> pages;
+	auto offset = sizeof(SavedAtlas) + m_pages.size()*sizeof(SavedPage);
+
+	for (auto& page : m_pages)
+	{
+		auto& skyline = page->skyline();
+		auto top = std::max_element(skyline.begin(), skyline.end(), [](const glm::ivec3& a, const glm::ivec3& b)
+		{
+			return a.y < b.y;
+		});
+
+		pages.push_back({static_cast<std::uint32_t>(top->y), 0, static_cast<std::uint32_t>(skyline.size()), static_cast<std::uint32_t>(offset)});
+		offset += skyline.size()*sizeof(SavedNode);
+	}
+
+	SavedAtlas atlas{PAGE_SIZE, static_cast<std::uint32_t>(m_pages.size()), static_cast<std::uint32_t>(glyphs.size()), static_cast<std::uint32_t>(offset)};
+	offset += glyphs.size()*sizeof(SavedGlyph);
+
+	for (auto& page : pages)
+	{
+		offset = (offset + SAVED_BITMAP_ALIGNMENT-1) & ~(SAVED_BITMAP_ALIGNMENT-1);
+		page.bitmapOffset = offset;
+		offset += PAGE_SIZE*page.rows;
+	}
+
+	std::vector<char> data(offset);
+	writeSaved(data, 0, atlas);
+
+	for (auto i = 0u; i < pages.size(); ++i)
+	{
+		auto& page = pages[i];
+		auto& skyline = m_pages[i]->skyline();
+
+		writeSaved(data, sizeof(SavedAtlas) + i*sizeof(SavedPage), page);
 
-	auto glyph = m_glyphMap.at(character);
-	info.quad = m_atlas->toQuad(glyph.region);
-	info.advance = glyph.advance;
-	info.bitmap_left = glyph.bitmap_left;
-	info.bitmap_top = glyph.bitmap_top;
-	return info;
+		for (auto n = 0u; n < skyline.size(); ++n)
+		{
+			writeSaved(data, page.skylineOffset + n*sizeof(SavedNode), SavedNode{skyline[n].x, skyline[n].y, skyline[n].z});
+		}
+
+		m_pages[i]->regionData(TextureAtlas::AtlasRegion(0, 0, PAGE_SIZE+1, page.rows+1), data.data() + page.bitmapOffset, PAGE_SIZE);
+	}
+
+	for (auto i = 0u; i < glyphs.size(); ++i)
+	{
+		writeSaved(data, atlas.glyphOffset + i*sizeof(SavedGlyph), glyphs[i]);
+	}
+
+	return data;
+}
+
+bool CharacterAtlas::load(const char *data, std::size_t size)
+{
+	if (!fits(size, 0, 1, sizeof(SavedAtlas)))
+		return false;
+
+	auto atlas = readSaved<SavedAtlas>(data, 0);
+
+	if (atlas.pageSize != PAGE_SIZE || !atlas.pageCount || atlas.pageCount > m_pageBudget)
+		return false;
+
+	if (!fits(size, sizeof(SavedAtlas), atlas.pageCount, sizeof(SavedPage)) || !fits(size, atlas.glyphOffset, atlas.glyphCount, sizeof(SavedGlyph)))
+		return false;
+
+	std::vector<SavedPage> pages;
+	std::vector<TextureAtlas::Skyline> skylines(atlas.pageCount);
+
+	// check everything before touching the atlas
+	for (auto i = 0u; i < atlas.pageCount; ++i)
+	{
+		auto page = readSaved<SavedPage>(data, sizeof(SavedAtlas) + i*sizeof(SavedPage));
+
+		if (page.rows > PAGE_SIZE || !fits(size, page.bitmapOffset, page.rows, PAGE_SIZE) || !fits(size, page.skylineOffset, page.skylineCount, sizeof(SavedNode)))
+			return false;
+
+		for (auto n = 0u; n < page.skylineCount; ++n)
+		{
+			auto node = readSaved<SavedNode>(data, page.skylineOffset + n*sizeof(SavedNode));
+			skylines[i].push_back(glm::ivec3(node.x, node.y, node.width));
+		}
+
+		if (!validSkyline(skylines[i], PAGE_SIZE, page.rows))
+			return false;
+
+		pages.push_back(page);
+	}
+
+	std::vector<SavedGlyph> glyphs;
+
+	for (auto i = 0u; i < atlas.glyphCount; ++i)
+	{
+		auto glyph = readSaved<SavedGlyph>(data, atlas.glyphOffset + i*sizeof(SavedGlyph));
+
+		if (glyph.page >= atlas.pageCount || glyph.x < 0 || glyph.y < 0 || glyph.width < 1 || glyph.height < 1
+			|| glyph.x + glyph.width > static_cast<int>(PAGE_SIZE) || glyph.y + glyph.height > static_cast<int>(PAGE_SIZE))
+			return false;
+
+		glyphs.push_back(glyph);
+	}
+
+	m_denseUsed.reset();
+	m_glyphMap.clear();
+
+	while (m_pages.size() > atlas.pageCount)
+	{
+		m_pages.pop_back();
+	}
+
+	while (m_pages.size() < atlas.pageCount)
+	{
+		addPage();
+	}
+
+	for (auto i = 0u; i < atlas.pageCount; ++i)
+	{
+		auto page = m_pages[i].get();
+		page->clear();
+		page->setRegion(TextureAtlas::AtlasRegion(0, 0, PAGE_SIZE+1, pages[i].rows+1), data + pages[i].bitmapOffset, PAGE_SIZE);
+		page->setSkyline(skylines[i]);
+	}
+
+	for (auto& glyph : glyphs)
+	{
+		insert
+		(
+			glyph.character,
+			TextureAtlas::AtlasRegion(glyph.x, glyph.y, glyph.width, glyph.height),
+			glyph.page,
+			glm::vec2(glyph.advanceX, glyph.advanceY),
+			glyph.left,
+			glyph.top
+		);
+	}
+
+	// every glyph may have moved
+	++m_generation;
+	return true;
+}
+
+void CharacterAtlas::bind(SceGxmContext *ctx, int unit, unsigned int page)
+{
+	if (page >= m_pages.size())
+		return;
+
+	// the pages are single buffered, so glyphs moved by a repack are only
+	// uploaded once the frames drawn from where they were are finished
+	if (m_moved)
+	{
+		FrameRing::instance()->waitIdle();
+		m_moved = false;
+	}
+
+	m_pages[page]->bind(ctx, unit);
+}
+
+CharacterAtlas::GlyphData *CharacterAtlas::glyph(unsigned int character)
+{
+	if (character < DENSE_GLYPHS)
+	{
+		return m_denseUsed[character] ? &m_denseGlyphs[character] : nullptr;
+	}
+
+	auto it = m_glyphMap.find(character);
+	return it == m_glyphMap.end() ? nullptr : &it->second;
+}
+
+void CharacterAtlas::insert(unsigned int character, const TextureAtlas::AtlasRegion& region, unsigned int page, const glm::vec2& advance, float left, float top)
+{
+	GlyphData data;
+	data.info.quad = m_pages[page]->toQuad(region);
+	data.info.advance = advance;
+	data.info.bitmap_left = left;
+	data.info.bitmap_top = top;
+	data.info.page = page;
+	data.region = region;
+	data.lastUsed = s_frame;
+
+	if (character < DENSE_GLYPHS)
+	{
+		m_denseGlyphs[character] = data;
+		m_denseUsed.set(character);
+	}
+	else
+	{
+		m_glyphMap[character] = data;
+	}
+}
+
+void CharacterAtlas::erase(unsigned int character)
+{
+	if (character < DENSE_GLYPHS)
+	{
+		m_denseUsed.reset(character);
+	}
+	else
+	{
+		m_glyphMap.erase(character);
+	}
+}
+
+std::vector<unsigned int> CharacterAtlas::characters(void) const
+{
+	std::vector<unsigned int> characters;
+	characters.reserve(m_denseUsed.count() + m_glyphMap.size());
+
+	for (auto i = 0u; i < DENSE_GLYPHS; ++i)
+	{
+		if (m_denseUsed[i])
+			characters.push_back(i);
+	}
+
+	for (auto& glyph : m_glyphMap)
+	{
+		characters.push_back(glyph.first);
+	}
+
+	return characters;
+}
+
+TextureAtlas *CharacterAtlas::addPage(void)
+{
+	auto page = std::make_unique<TextureAtlas>(PAGE_SIZE, PAGE_SIZE);
+	page->setFormat(GxmTexture::U8_R111);
+	page->create(m_minFilter, GxmTexture::Linear);
+
+	m_pages.push_back(std::move(page));
+	return m_pages.back().get();
+}
+
+bool CharacterAtlas::place(std::size_t width, std::size_t height, TextureAtlas::AtlasRegion *region, unsigned int *page)
+{
+	auto fits = [&](unsigned int index)
+	{
+		*region = m_pages[index]->region(width, height);
+		*page = index;
+		return region->x != -1 && region->y != -1;
+	};
+
+	for (auto i = 0u; i < m_pages.size(); ++i)
+	{
+		if (fits(i))
+			return true;
+	}
+
+	if (m_pages.size() < m_pageBudget)
+	{
+		addPage();
+		return fits(m_pages.size()-1);
+	}
+
+	// this may be in the middle of drawing, where moving glyphs would pull
+	// them from under text already drawn. the caller gets an empty glyph
+	// and collect makes room before the next frame
+	m_full = true;
+	return false;
+}
+
+bool CharacterAtlas::repack(unsigned int page)
+{
+	struct HotGlyph
+	{
+		unsigned int character;
+		std::vector<char> bitmap;
+	};
+
+	auto atlas = m_pages[page].get();
+	std::vector<HotGlyph> hot;
+
+	// keep a copy of everything still in use, the rest goes
+	for (auto character : characters())
+	{
+		auto data = glyph(character);
+
+		if (data->info.page != page)
+			continue;
+
+		if (cold(data))
+		{
+			erase(character);
+			++m_evictions;
+			continue;
+		}
+
+		auto width = data->region.z-1;
+		auto height = data->region.w-1;
+
+		hot.push_back({character, std::vector<char>(width*height)});
+		atlas->regionData(data->region, hot.back().bitmap.data(), width);
+	}
+
+	std::vector<glm::uvec2> sizes;
+	sizes.reserve(hot.size());
+
+	for (auto& hotGlyph : hot)
+	{
+		auto data = glyph(hotGlyph.character);
+		sizes.push_back(glm::uvec2(data->region.z-1, data->region.w-1));
+	}
+
+	atlas->clear();
+
+	auto regions = atlas->regionBatch(sizes);
+
+	for (auto i = 0u; i < hot.size(); ++i)
+	{
+		auto data = glyph(hot[i].character);
+		auto& region = regions[i];
+
+		// they fitted before, but a different order can pack worse
+		if (region.x == -1 || region.y == -1)
+		{
+			erase(hot[i].character);
+			++m_evictions;
+			continue;
+		}
+
+		atlas->setRegion(region, hot[i].bitmap.data(), sizes[i].x);
+		data->region = region;
+		data->info.quad = atlas->toQuad(region);
+	}
+
+	// every glyph on this page has moved or gone
+	++m_generation;
+	m_moved = true;
+	return true;
 }
 
-void CharacterAtlas::bind(SceGxmContext *ctx, int unit)
+bool CharacterAtlas::cold(const GlyphData *data) const
 {
-	m_atlas->bind(ctx, unit);
+	return s_frame - data->lastUsed > COLD_FRAMES;
 }
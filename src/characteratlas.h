@@ -12,12 +12,26 @@
 
 #include "textureatlas.h"
 
+#include <framework/framering.h>
+
 #include <glm/vec2.hpp>
 
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 struct FT_GlyphSlotRec_;
 
+// glyphs are packed into as many 512x512 pages as they need, up to a budget.
+// once the budget is reached a glyph that does not fit is left out, and
+// between frames collect evicts the glyphs that no frame still queued for
+// display has used and repacks the rest. any geometry built from glyph info
+// should be rebuilt when generation() changes.
+// glyph info is computed once when a glyph is placed. latin-1 is looked up
+// directly in a table, only other codepoints go through the hash map
 class CharacterAtlas
 {
 public:
@@ -27,30 +41,106 @@ public:
 		glm::vec2 advance;
 		float bitmap_left;
 		float bitmap_top;
+		unsigned int page{0};
+	};
+
+	struct Statistics
+	{
+		std::size_t pages;
+		std::size_t glyphs;
+		float occupancy;
+		unsigned int evictions;
+		unsigned int rasterizations;
+		std::size_t uploadedBytes;
 	};
 
+	static constexpr std::size_t PAGE_SIZE = 512;
+	static constexpr std::size_t DEFAULT_PAGE_BUDGET = 4;
+	static constexpr unsigned int DENSE_GLYPHS = 256;
+
+	// a glyph unused for this many frames is in none the gpu may still draw
+	static constexpr unsigned int COLD_FRAMES = FrameRing::FRAMES;
+
 public:
-	CharacterAtlas(void);
+	// distance fields are sampled with linear filtering when minified as well,
+	// bitmaps drawn at their rendered size keep point sampling
+	explicit CharacterAtlas(GxmTexture::Filter minFilter = GxmTexture::Point, std::size_t pageBudget = DEFAULT_PAGE_BUDGET);
 	~CharacterAtlas(void);
 
+	// counts the frames glyphs were last used in
+	static void nextFrame(void);
+
+	// makes room once a glyph has not fitted, by evicting cold glyphs and
+	// repacking the pages they were on. only between frames, as that moves
+	// glyphs. true if anything moved
+	bool collect(void);
+
 	bool contains(unsigned int character);
 	bool addGlyph(unsigned int character, const FT_GlyphSlotRec_ *glyph);
+	bool addGlyph(unsigned int character, const char *bitmap, std::size_t width, std::size_t rows, std::size_t pitch, const glm::vec2& advance, float left, float top);
+
+	// a page packed ahead of time by tools/glyphbake.py. its glyphs are added
+	// with addBakedGlyph and anything rendered later is packed below them
+	bool setBakedPage(const char *bitmap, std::size_t width, std::size_t rows);
+	void addBakedGlyph(unsigned int character, const TextureAtlas::AtlasRegion& region, const glm::vec2& advance, float left, float top);
+
+	// glyph info marks the glyph as used this frame, as does touch. find
+	// returns nullptr for glyphs not in the atlas
 	GlyphInfo glyphInfo(unsigned int character);
+	const GlyphInfo *find(unsigned int character);
+	void touch(unsigned int character);
+
+	unsigned int generation(void) const;
+	Statistics statistics(void) const;
 
-	void bind(SceGxmContext *ctx, int unit);
+	// glyphs are copied to the page textures when they are next bound
+	std::size_t uploadedBytes(void) const;
+
+	// the pages, their free space and the info of every glyph, so GlyphStore
+	// can keep them between launches. load replaces the whole atlas, or
+	// leaves it alone if the data is truncated or not a valid atlas
+	std::vector<char> save(void) const;
+	bool load(const char *data, std::size_t size);
+
+	void bind(SceGxmContext *ctx, int unit, unsigned int page = 0);
 
 private:
 	struct GlyphData
 	{
+		GlyphInfo info;
 		TextureAtlas::AtlasRegion region;
-		glm::vec2 advance;
-		float bitmap_left;
-		float bitmap_top;
+		unsigned int lastUsed;
 	};
 
 private:
-	TextureAtlas *m_atlas;
+	GlyphData *glyph(unsigned int character);
+	void insert(unsigned int character, const TextureAtlas::AtlasRegion& region, unsigned int page, const glm::vec2& advance, float left, float top);
+	void erase(unsigned int character);
+	std::vector<unsigned int> characters(void) const;
+
+	TextureAtlas *addPage(void);
+	bool place(std::size_t width, std::size_t height, TextureAtlas::AtlasRegion *region, unsigned int *page);
+	bool repack(unsigned int page);
+	bool cold(const GlyphData *data) const;
+
+private:
+	static std::atomic<unsigned int> s_frame;
+
+	GxmTexture::Filter m_minFilter;
+	std::size_t m_pageBudget;
+	std::vector<std::unique_ptr<TextureAtlas>> m_pages;
+	std::array<GlyphData, DENSE_GLYPHS> m_denseGlyphs;
+	std::bitset<DENSE_GLYPHS> m_denseUsed;
 	std::unordered_map<unsigned int, GlyphData> m_glyphMap;
+
+	unsigned int m_generation{0};
+	unsigned int m_evictions{0};
+	unsigned int m_rasterizations{0};
+
+	// a glyph did not fit since the last collect, and a repack has moved
+	// glyphs that are in frames the gpu may not have finished
+	bool m_full{false};
+	bool m_moved{false};
 };
 
 #endif // CHARACTERATLAS_H
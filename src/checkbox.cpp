@@ -10,47 +10,11 @@
 #include "checkbox.h"
 #include "geometryrenderer.h"
 #include "text.h"
-#include "resource.h"
 #include "easingcurves.h"
+#include "texturecache.h"
 
-#include <png++/png.hpp>
-
-namespace
-{
-	void loadTexture(GxmTexture *texture, const char *file)
-	{
-		class VectorStream : public std::basic_streambuf<char, std::char_traits<char>>
-		{
-		public:
-			VectorStream(std::vector<char>& v)
-			{
-				setg(v.data(), v.data(), v.data()+v.size());
-			}
-		};
-		
-		auto fileData = Resource::read(file);
-		
-		if (!fileData.good)
-		{
-			LOG(FATAL) << "could not load texture: "  << file;
-		}
-
-		VectorStream vstream(fileData.data);
-		std::istream stream(&vstream);
-		
-		png::image<png::rgba_pixel, png::solid_pixel_buffer<png::rgba_pixel>> image(stream);
-		
-		texture->setSize(image.get_width(), image.get_height());
-		texture->setFormat(GxmTexture::ARGB8);
-		texture->allocateStorage();
-		texture->setData(image.get_pixbuf().get_bytes().data());
-		texture->setMinMagFilter(GxmTexture::Linear, GxmTexture::Linear);
-		texture->setWrapMode(GxmTexture::Repeat);
-	}
-}
-
-CheckBox::CheckBox(GeometryRenderer *geometryRenderer, GeometryRenderer *textRenderer)
-	: m_geometryRenderer(geometryRenderer)
+CheckBox::CheckBox(GeometryRenderer *textureRenderer, GeometryRenderer *textRenderer)
+	: m_textureRenderer(textureRenderer)
 	, m_textRenderer(textRenderer)
 	, m_checked(true)
 	, m_text(nullptr)
@@ -64,11 +28,17 @@ CheckBox::CheckBox(GeometryRenderer *geometryRenderer, GeometryRenderer *textRen
 	m_checkboxUnselected.setHeight(50);
 	m_checkboxUnselected.setColour(glm::vec4(1.f, 1.f, 1.f, 1.f));
 
-	loadTexture(&m_checkedTexture, "rsc:/textures/checkbox-checked.png");
-	loadTexture(&m_uncheckedTexture, "rsc:/textures/checkbox-unchecked.png");
+	auto textures = TextureCache::instance()->textures(
+	{
+		"rsc:/textures/checkbox-checked.rtex",
+		"rsc:/textures/checkbox-unchecked.rtex"
+	});
+
+	m_checkedTexture = textures[0];
+	m_uncheckedTexture = textures[1];
 
-	m_checkboxSelected.setTexture(&m_checkedTexture);
-	m_checkboxUnselected.setTexture(&m_uncheckedTexture);
+	m_checkboxSelected.setTexture(m_checkedTexture.get());
+	m_checkboxUnselected.setTexture(m_uncheckedTexture.get());
 
 	m_checkedAnimation.setDuration(200);
 	m_checkedAnimation.setEasing([this](auto t, auto b, auto c, auto d)
@@ -162,7 +132,7 @@ void CheckBox::update(float dt)
 
 void CheckBox::draw(SceGxmContext *ctx, const Camera *camera) const
 {
-	m_textRenderer->draw(ctx, camera, &m_checkboxSelected);
-	m_textRenderer->draw(ctx, camera, &m_checkboxUnselected);
+	m_textureRenderer->draw(ctx, camera, &m_checkboxSelected);
+	m_textureRenderer->draw(ctx, camera, &m_checkboxUnselected);
 	m_textRenderer->draw(ctx, camera, m_text);
 }
@@ -14,6 +14,7 @@
 #include "vertextypes.h"
 #include "texturerectangle.h"
 #include "numberanimation.h"
+#include "texturecache.h"
 
 class GeometryRenderer;
 class Text;
@@ -21,7 +22,7 @@ class Text;
 class CheckBox : public WorldEntity
 {
 public:
-	CheckBox(GeometryRenderer *geometryRenderer, GeometryRenderer *textRenderer);
+	CheckBox(GeometryRenderer *textureRenderer, GeometryRenderer *textRenderer);
 
 	void setText(Text *text);
 
@@ -40,13 +41,13 @@ private:
 	void positionComponents(void);
 
 private:
-	GeometryRenderer *m_geometryRenderer;
+	GeometryRenderer *m_textureRenderer;
 	GeometryRenderer *m_textRenderer;
 	bool m_checked;
-	TextureRectangle<ColouredTextureVertex> m_checkboxSelected, m_checkboxUnselected;
+	TextureRectangle<CompactTextureVertex> m_checkboxSelected, m_checkboxUnselected;
 	Text *m_text;
 	float m_width;
-	GxmTexture m_checkedTexture, m_uncheckedTexture;
+	TextureCache::TexturePtr m_checkedTexture, m_uncheckedTexture;
 	NumberAnimation m_checkedAnimation;
 };
 
@@ -69,7 +69,7 @@ private:
 
 private:
 	std::vector<Item> m_items;
-	Rectangle<ColouredGeometryVertex> m_selectionBox;
+	Rectangle<CompactGeometryVertex> m_selectionBox;
 	GeometryRenderer *m_geometryRenderer;
 	GeometryRenderer *m_textRenderer;
 	StateMachine m_stateMachine;
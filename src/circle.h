@@ -10,11 +10,14 @@
 #ifndef CIRCLE_H
 #define CIRCLE_H
 
-#include <framework/gpumemoryblock.h>
+#include <framework/framering.h>
+#include <framework/gpuheap.h>
 #include <memory>
 #include "geometry.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 template <typename Vertex>
 class Circle : public Geometry
@@ -37,8 +40,10 @@ private:
 	void doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const override;
 
 private:
-	std::unique_ptr<GpuMemoryBlock<Vertex>> m_vertices;
-	std::unique_ptr<GpuMemoryBlock<uint16_t>> m_indices;
+	// the vertices are copied to the frame ring each draw, so they can
+	// change while on screen. the indices only change with the steps
+	std::vector<Vertex> m_vertices;
+	std::unique_ptr<GpuHeapBlock<uint16_t>> m_indices;
 
 	std::size_t m_steps;
 	float m_radius;
@@ -54,19 +59,26 @@ Circle<Vertex>::Circle(float radius, std::size_t steps)
 template <typename Vertex>
 void Circle<Vertex>::setSteps(std::size_t steps)
 {
-	m_vertices = std::make_unique<GpuMemoryBlock<Vertex>>
-	(
-		steps+1,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_indices = std::make_unique<GpuMemoryBlock<uint16_t>>
-	(
-		steps+2,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
+	// the old indices may still be on screen
+	if (m_indices)
+	{
+		FrameRing::instance()->release(std::move(m_indices));
+	}
+
+	m_vertices.resize(steps+1);
+	m_indices = std::make_unique<GpuHeapBlock<uint16_t>>(steps+2);
 
 	m_steps = steps;
+
+	auto indices = m_indices->address();
+
+	// a fan from the centre, ending on the first vertex on the edge
+	for (auto i = 0u; i < m_steps+1; ++i)
+	{
+		indices[i] = i;
+	}
+
+	indices[m_steps+1] = 1;
 	setRadius(m_radius);
 }
 
@@ -79,12 +91,8 @@ std::size_t Circle<Vertex>::steps(void) const
 template <typename Vertex>
 void Circle<Vertex>::setRadius(float radius)
 {
-	auto vertices = m_vertices->address();
-	auto indices = m_indices->address();
-	
 	// add centre
-	vertices[0].position = glm::vec3(radius, radius, 0.f);
-	indices[0] = 0;
+	m_vertices[0].position = glm::vec3(radius, radius, 0.f);
 	
 	constexpr auto pi = 3.141592653589793238462643383279502884;
 	auto theta = 2*pi / static_cast<float>(m_steps);
@@ -93,12 +101,9 @@ void Circle<Vertex>::setRadius(float radius)
 	for (auto i = 0u; i < m_steps; ++i)
 	{
 		// +1 to consider the centre vertex
-		vertices[i+1].position = glm::vec3(radius+radius*std::cos(theta*i), radius+radius*std::sin(theta*i), 0.f);
-		indices[i+1] = i+1;
+		m_vertices[i+1].position = glm::vec3(radius+radius*std::cos(theta*i), radius+radius*std::sin(theta*i), 0.f);
 	}
 
-	// end fan on first vertex on edge
-	indices[m_steps+1] = 1;
 	m_radius = radius;
 }
 
@@ -112,19 +117,20 @@ template <typename Vertex>
 template <typename Colour>
 void Circle<Vertex>::setColour(Colour colour)
 {
-	auto vertices = m_vertices->address();
-
 	// apply colour to all vertices
-	for (auto i = 0u; i < m_vertices->count(); ++i)
+	for (auto& vertex : m_vertices)
 	{
-		vertices[i].colour = colour;
+		vertex.colour = colour;
 	}
 }
 
 template <typename Vertex>
 void Circle<Vertex>::doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const
 {
-	sceGxmSetVertexStream(ctx, 0, m_vertices->address());
+	auto vertices = FrameRing::instance()->allocate<Vertex>(m_vertices.size());
+	std::copy(m_vertices.begin(), m_vertices.end(), vertices);
+
+	sceGxmSetVertexStream(ctx, 0, vertices);
 	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLE_FAN, SCE_GXM_INDEX_FORMAT_U16, m_indices->address(), m_indices->count());
 }
 
@@ -10,11 +10,14 @@
 #ifndef CIRCULARSEGMENT_H
 #define CIRCULARSEGMENT_H
 
-#include <framework/gpumemoryblock.h>
+#include <framework/framering.h>
+#include <framework/gpuheap.h>
 #include <memory>
 #include "geometry.h"
 
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 template <typename Vertex>
 class CircularSegment : public Geometry
@@ -37,8 +40,10 @@ private:
 	void doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const override;
 
 private:
-	std::unique_ptr<GpuMemoryBlock<Vertex>> m_vertices;
-	std::unique_ptr<GpuMemoryBlock<uint16_t>> m_indices;
+	// the vertices are copied to the frame ring each draw, so they can
+	// change while on screen. the indices only change with the steps
+	std::vector<Vertex> m_vertices;
+	std::unique_ptr<GpuHeapBlock<uint16_t>> m_indices;
 
 	std::size_t m_steps;
 	float m_radius;
@@ -57,25 +62,21 @@ CircularSegment<Vertex>::CircularSegment(float radius, float angle, std::size_t
 template <typename Vertex>
 void CircularSegment<Vertex>::setSteps(std::size_t steps)
 {
-	m_vertices = std::make_unique<GpuMemoryBlock<Vertex>>
-	(
-		steps+1,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_indices = std::make_unique<GpuMemoryBlock<uint16_t>>
-	(
-		steps+2,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
+	// the old indices may still be on screen
+	if (m_indices)
+	{
+		FrameRing::instance()->release(std::move(m_indices));
+	}
+
+	m_vertices.resize(steps+1);
+	m_indices = std::make_unique<GpuHeapBlock<uint16_t>>(steps+2);
 
 	m_steps = steps;
 
-	auto vertices = m_vertices->address();
 	auto indices = m_indices->address();
 	
 	// add centre
-	vertices[0].position = glm::vec3(0.f, 0.f, 0.f);
+	m_vertices[0].position = glm::vec3(0.f, 0.f, 0.f);
 	indices[0] = 0;
 	
 	constexpr auto pi = 3.141592653589793238462643383279502884;
@@ -85,7 +86,7 @@ void CircularSegment<Vertex>::setSteps(std::size_t steps)
 	for (auto i = 0u; i < m_steps; ++i)
 	{
 		// +1 to consider the centre vertex
-		vertices[i+1].position = glm::vec3(std::cos(theta*i), std::sin(theta*i), 0.f);
+		m_vertices[i+1].position = glm::vec3(std::cos(theta*i), std::sin(theta*i), 0.f);
 		indices[i+1] = i+1;
 	}
 
@@ -119,19 +120,20 @@ template <typename Vertex>
 template <typename Colour>
 void CircularSegment<Vertex>::setColour(Colour colour)
 {
-	auto vertices = m_vertices->address();
-
 	// apply colour to all vertices
-	for (auto i = 0u; i < m_vertices->count(); ++i)
+	for (auto& vertex : m_vertices)
 	{
-		vertices[i].colour = colour;
+		vertex.colour = colour;
 	}
 }
 
 template <typename Vertex>
 void CircularSegment<Vertex>::doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const
 {
-	sceGxmSetVertexStream(ctx, 0, m_vertices->address());
+	auto vertices = FrameRing::instance()->allocate<Vertex>(m_vertices.size());
+	std::copy(m_vertices.begin(), m_vertices.end(), vertices);
+
+	sceGxmSetVertexStream(ctx, 0, vertices);
 	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLE_FAN, SCE_GXM_INDEX_FORMAT_U16, m_indices->address(), m_indices->count());
 }
 
@@ -17,16 +17,20 @@ ConfigPage::ConfigPage(GxmShaderPatcher *patcher)
 	: m_rectangle((960-200), 400, 20)
 	, m_renderer(patcher)
 	, m_textRenderer(patcher)
+	, m_textureRenderer(patcher)
 	, m_font20("rsc:/fonts/DroidSans.ttf")
 	, m_font10("rsc:/fonts/DroidSans.ttf")
 	, m_font8("rsc:/fonts/DroidSans.ttf")
 	, m_menu(&m_renderer, &m_textRenderer)
-	, m_unsafeCheckbox(&m_renderer, &m_textRenderer)
-	, m_spoofCheckbox(&m_renderer, &m_textRenderer)
+	, m_unsafeCheckbox(&m_textureRenderer, &m_textRenderer)
+	, m_spoofCheckbox(&m_textureRenderer, &m_textRenderer)
 {
 	m_font20.setPointSize(20.f);
 	m_font10.setPointSize(10.f);
 	m_font8.setPointSize(8.f);
+	m_font20.setDistanceField(true);
+	m_font10.setDistanceField(true);
+	m_font8.setDistanceField(true);
 	
 	m_rectangle.setColour(glm::vec4(0.f, 0.f, 0.f, 0.5f));
 
@@ -77,10 +81,15 @@ ConfigPage::ConfigPage(GxmShaderPatcher *patcher)
 	blendInfo.colorMask = SCE_GXM_COLOR_MASK_ALL;
 
 	m_renderer.setBlendInfo(&blendInfo);
-	m_renderer.setShaders<ColouredGeometryVertex>("rsc:/colour.vert.cg.gxp", "rsc:/colour.frag.cg.gxp");
+	m_renderer.setShaders<CompactGeometryVertex>("rsc:/compactcolour.vert.cg.gxp"_rsc, "rsc:/colour.frag.cg.gxp"_rsc);
 
 	m_textRenderer.setBlendInfo(&blendInfo);
-	m_textRenderer.setShaders<ColouredTextureVertex>("rsc:/text.vert.cg.gxp", "rsc:/text.frag.cg.gxp");
+	m_textRenderer.setShaders<TextVertex>("rsc:/text.vert.cg.gxp"_rsc, "rsc:/sdftext.frag.cg.gxp"_rsc);
+
+	// the checkbox images are ordinary textures, only glyphs are distance
+	// fields. they keep a colour per vertex, unlike text
+	m_textureRenderer.setBlendInfo(&blendInfo);
+	m_textureRenderer.setShaders<CompactTextureVertex>("rsc:/compacttexture.vert.cg.gxp"_rsc, "rsc:/text.frag.cg.gxp"_rsc);
 }
 
 void ConfigPage::onModelChanged(glm::mat4 model)
@@ -48,8 +48,8 @@ private:
 	void positionComponents(void);
 
 private:
-	RoundedRectangle<ColouredGeometryVertex> m_rectangle;
-	GeometryRenderer m_renderer, m_textRenderer;
+	RoundedRectangle<CompactGeometryVertex> m_rectangle;
+	GeometryRenderer m_renderer, m_textRenderer, m_textureRenderer;
 	Font m_font20, m_font10, m_font8;
 	Text m_titleText, m_nextPageDirection, m_unsafeLabel, m_unsafeLabelDesc, m_spoofLabel, m_spoofLabelDesc;
 	CheckBoxMenu m_menu;
@@ -0,0 +1,132 @@
+/*
+ * distancefield.cpp - signed distance fields from rendered glyph bitmaps
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "distancefield.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr float FAR = 1e20f;
+
+	// felzenszwalb and huttenlocher's squared distance transform of one row or
+	// column. each output is the squared distance to the nearest zero input
+	void transform(float *f, std::size_t n, std::size_t step, std::vector<float>& d, std::vector<int>& v, std::vector<float>& z)
+	{
+		auto k = 0;
+		v[0] = 0;
+		z[0] = -FAR;
+		z[1] = FAR;
+
+		for (auto q = 1; q < static_cast<int>(n); ++q)
+		{
+			auto fq = f[q*step] + q*q;
+			auto s = (fq - (f[v[k]*step] + v[k]*v[k])) / (2*q - 2*v[k]);
+
+			while (s <= z[k])
+			{
+				--k;
+				s = (fq - (f[v[k]*step] + v[k]*v[k])) / (2*q - 2*v[k]);
+			}
+
+			++k;
+			v[k] = q;
+			z[k] = s;
+			z[k+1] = FAR;
+		}
+
+		k = 0;
+
+		for (auto q = 0; q < static_cast<int>(n); ++q)
+		{
+			while (z[k+1] < q)
+				++k;
+
+			d[q] = (q - v[k])*(q - v[k]) + f[v[k]*step];
+		}
+
+		for (auto q = 0u; q < n; ++q)
+		{
+			f[q*step] = d[q];
+		}
+	}
+
+	void transform(std::vector<float>& grid, std::size_t width, std::size_t height)
+	{
+		auto n = std::max(width, height);
+		std::vector<float> d(n);
+		std::vector<int> v(n);
+		std::vector<float> z(n+1);
+
+		for (auto x = 0u; x < width; ++x)
+		{
+			transform(grid.data() + x, height, width, d, v, z);
+		}
+
+		for (auto y = 0u; y < height; ++y)
+		{
+			transform(grid.data() + y*width, width, 1, d, v, z);
+		}
+	}
+} // anonymous namespace
+
+namespace DistanceField
+{
+	std::vector<char> generate(const unsigned char *bitmap, std::size_t width, std::size_t rows, int pitch)
+	{
+		auto fieldWidth = width + 2*SPREAD;
+		auto fieldHeight = rows + 2*SPREAD;
+		auto size = fieldWidth*fieldHeight;
+
+		std::vector<float> coverage(size, 0.f);
+
+		for (auto y = 0u; y < rows; ++y)
+		{
+			for (auto x = 0u; x < width; ++x)
+			{
+				coverage[(y+SPREAD)*fieldWidth + x+SPREAD] = bitmap[y*pitch + x]/255.f;
+			}
+		}
+
+		// squared distances from every pixel to the nearest pixel inside the
+		// glyph, and to the nearest pixel outside it
+		std::vector<float> outside(size), inside(size);
+
+		for (auto i = 0u; i < size; ++i)
+		{
+			outside[i] = (coverage[i] >= 0.5f) ? 0.f : FAR;
+			inside[i] = (coverage[i] >= 0.5f) ? FAR : 0.f;
+		}
+
+		transform(outside, fieldWidth, fieldHeight);
+		transform(inside, fieldWidth, fieldHeight);
+
+		std::vector<char> field(size);
+
+		for (auto i = 0u; i < size; ++i)
+		{
+			float distance;
+
+			// antialiased pixels straddle the outline, so their coverage is a
+			// better estimate than the distance between pixel centres
+			if (coverage[i] > 0.f && coverage[i] < 1.f)
+				distance = 0.5f - coverage[i];
+			else if (coverage[i] >= 0.5f)
+				distance = 0.5f - std::sqrt(inside[i]);
+			else
+				distance = std::sqrt(outside[i]) - 0.5f;
+
+			auto value = 0.5f - distance/(2*SPREAD);
+			field[i] = static_cast<char>(std::lround(std::min(std::max(value, 0.f), 1.f)*255.f));
+		}
+
+		return field;
+	}
+}
@@ -0,0 +1,29 @@
+/*
+ * distancefield.h - signed distance fields from rendered glyph bitmaps
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include <cstddef>
+#include <vector>
+
+namespace DistanceField
+{
+	// the distance in pixels either side of the outline the field covers. the
+	// field is this much larger than the bitmap on every edge
+	constexpr int SPREAD = 4;
+
+	// converts an 8 bit coverage bitmap to a field of (width+2*SPREAD) by
+	// (rows+2*SPREAD) bytes. the outline sits at 128, inside is brighter and
+	// outside is darker, falling to 0 and 255 at SPREAD pixels away.
+	// tools/glyphbake.py bakes pages with the same transform
+	std::vector<char> generate(const unsigned char *bitmap, std::size_t width, std::size_t rows, int pitch);
+}
+
+#endif // DISTANCEFIELD_H
@@ -8,41 +8,11 @@
  */
 
 #include "font.h"
-#include "resource.h"
+#include "fontcache.h"
 
-#include <freetype2/ft2build.h>
-#include FT_FREETYPE_H
+#include <utf8cpp/utf8.h>
 
-namespace
-{
-	class FreeType
-	{
-	public:
-		static FT_Library& library(void)
-		{
-			return FreeType::instance()->m_library;
-		}
-
-	private:
-		FreeType(void)
-		{
-			FT_Init_FreeType(&m_library);
-		}
-
-		~FreeType(void)
-		{
-			FT_Done_FreeType(m_library);
-		}
-
-		static FreeType *instance(void)
-		{
-			static FreeType freetype;
-			return &freetype;
-		}
-
-		FT_Library m_library;
-	};
-}
+#include <iterator>
 
 Font::Font(void)
 {
@@ -56,85 +26,141 @@ Font::Font(const std::string& file)
 
 Font::~Font(void)
 {
-	delete m_atlas;
 }
 
 bool Font::setFont(const std::string& file)
 {
-	if (m_atlas != nullptr)
-	{
-		delete m_atlas;
-		m_atlas = nullptr;
-	}
+	m_store.reset();
 
-	if (m_face != nullptr)
+	if (!FontCache::instance()->fontData(file).good)
 	{
-		// TODO: handle this
+		m_file.clear();
+		return false;
 	}
 
-	m_atlas = new CharacterAtlas;
+	m_file = file;
+	return true;
+}
 
-	auto fileData = Resource::read(file);
-	
-	if (!fileData.good)
-		return false;
+void Font::setPointSize(float size)
+{
+	if (size == m_pointSize)
+		return;
 
-	m_fontData = std::move(fileData.data);
+	m_pointSize = size;
 
-	FT_New_Memory_Face(FreeType::library(), reinterpret_cast<FT_Byte *>(m_fontData.data()), m_fontData.size(), 0, &m_face);
-	FT_Set_Char_Size(m_face, 0, 16*64, 960/4.357877685622746f, 544/2.451306198162795);
-	return true;
+	// the distance field store is the same for every size
+	if (!m_distanceField)
+		m_store.reset();
 }
 
-void Font::setPointSize(float size)
+void Font::setDistanceField(bool enabled)
 {
-	FT_Set_Char_Size(m_face, 0, FT_F26Dot6(size*64), 960/4.357877685622746f, 544/2.451306198162795);
+	if (enabled == m_distanceField)
+		return;
 
-	// TODO: implement a clear rather than rebuild expensive object
-	if (m_atlas != nullptr)
-	{
-		delete m_atlas;
-	}
+	m_distanceField = enabled;
+	m_store.reset();
+}
 
-	m_atlas = new CharacterAtlas;
+bool Font::distanceField(void) const
+{
+	return m_distanceField;
 }
 
 bool Font::kerning(void) const
 {
-	return FT_HAS_KERNING(m_face);
+	auto glyphs = store();
+	return glyphs && glyphs->kerning();
 }
 
 glm::vec2 Font::kerningInfo(unsigned int character, unsigned int prev)
 {
-	glm::vec2 info(0, 0);
+	auto glyphs = store();
+
+	if (!glyphs)
+		return glm::vec2(0, 0);
 
-	if (!kerning())
-		return info;
+	return glyphs->kerningInfo(character, prev)*scale();
+}
+
+Font::GlyphInfo Font::glyphInfo(unsigned int character)
+{
+	auto glyphs = store();
 
-	FT_Vector dxy;
-	FT_Get_Kerning(m_face, FT_Get_Char_Index(m_face, prev), FT_Get_Char_Index(m_face, character), FT_KERNING_DEFAULT, &dxy);
+	// built in place and returned as it is, copying the info costs more
+	// than looking it up
+	auto info = glyphs ? glyphs->glyphInfo(character) : GlyphInfo();
 
-	info.x = dxy.x >> 6;
-	info.y = dxy.y >> 6;
+	if (m_distanceField)
+	{
+		auto factor = scale();
+		info.quad.size *= factor;
+		info.advance *= factor;
+		info.bitmap_left *= factor;
+		info.bitmap_top *= factor;
+	}
 
 	return info;
 }
 
-Font::GlyphInfo Font::glyphInfo(unsigned int character)
+void Font::preload(const std::string& text)
 {
-	if (!m_atlas->contains(character))
+	auto glyphs = store();
+
+	if (!glyphs)
+		return;
+
+	// text changed every frame is almost always made of glyphs already in
+	// the atlas, which needs nothing allocated to find out
+	auto cached = true;
+
+	for (auto it = text.begin(); cached && it != text.end();)
 	{
-		auto glyphIndex = FT_Get_Char_Index(m_face, character);
-		FT_Load_Glyph(m_face, glyphIndex, FT_LOAD_DEFAULT);
-		// TODO: check errors
-		FT_Render_Glyph(m_face->glyph, FT_RENDER_MODE_NORMAL);
-		m_atlas->addGlyph(character, m_face->glyph);
+		cached = glyphs->atlas()->contains(utf8::next(it, text.end()));
 	}
 
-	return m_atlas->glyphInfo(character);
+	if (cached)
+		return;
+
+	std::vector<unsigned int> characters;
+	utf8::utf8to32(text.begin(), text.end(), std::back_inserter(characters));
+	preload(characters);
+}
+
+void Font::preload(std::u32string_view text)
+{
+	preload(std::vector<unsigned int>(text.begin(), text.end()));
+}
+
+void Font::preload(const std::vector<unsigned int>& characters)
+{
+	auto glyphs = store();
+
+	if (!glyphs)
+		return;
+
+	glyphs->preload(characters);
 }
 
 CharacterAtlas *Font::atlas(void) const
 {
-	return m_atlas;
+	auto glyphs = store();
+	return glyphs ? glyphs->atlas() : nullptr;
+}
+
+GlyphStore *Font::store(void) const
+{
+	if (!m_store && !m_file.empty())
+	{
+		auto size = m_distanceField ? GlyphStore::DISTANCE_FIELD_SIZE : m_pointSize;
+		m_store = FontCache::instance()->glyphStore(m_file, size, m_distanceField);
+	}
+
+	return m_store.get();
+}
+
+float Font::scale(void) const
+{
+	return m_distanceField ? m_pointSize/GlyphStore::DISTANCE_FIELD_SIZE : 1.f;
 }
@@ -12,14 +12,18 @@
 
 #include "characteratlas.h"
 
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
-struct FT_FaceRec_;
+class GlyphStore;
 
 class Font
 {
 	friend class TextRenderer;
-	friend class Text;
+	friend class TextMesh;
+	friend class TextMeshCache;
 	
 public:
 	using GlyphInfo = CharacterAtlas::GlyphInfo;
@@ -32,18 +36,36 @@ public:
 	bool setFont(const std::string& file);
 	void setPointSize(float size);
 
+	// draw from a distance field rendered once per file, scaled to the point
+	// size. these need a distance field shader such as sdftext.frag.cg
+	void setDistanceField(bool enabled);
+	bool distanceField(void) const;
+
 	bool kerning(void) const;
 	glm::vec2 kerningInfo(unsigned int character, unsigned int prev);
 
 	Font::GlyphInfo glyphInfo(unsigned int character);
 
+	// rasterise every glyph of some text up front, in parallel where there
+	// are enough missing. text is utf-8
+	void preload(const std::string& text);
+	void preload(std::u32string_view text);
+	void preload(const std::vector<unsigned int>& characters);
+
 private:
 	CharacterAtlas *atlas(void) const;
+	GlyphStore *store(void) const;
+	float scale(void) const;
 
 private:
-	FT_FaceRec_ *m_face{nullptr};
-	std::vector<char> m_fontData;
-	CharacterAtlas *m_atlas{nullptr};
+	// a font is only a handle onto the shared glyph store for its file and
+	// size. the store is resolved on first use so setFont followed by
+	// setPointSize does not create a store for the default size. distance
+	// field fonts of every size share the one store for their file
+	std::string m_file;
+	float m_pointSize{16.f};
+	bool m_distanceField{false};
+	mutable std::shared_ptr<GlyphStore> m_store;
 };
 
 #endif // FONT_H
@@ -0,0 +1,785 @@
+/*
+ * fontcache.cpp - process-wide cache of font faces and glyph stores
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "fontcache.h"
+#include "distancefield.h"
+#include "resource.h"
+
+#include <framework/taskscheduler.h>
+
+#include <freetype2/ft2build.h>
+#include FT_FREETYPE_H
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+	// written by tools/glyphbake.py
+	struct BakedGlyphsHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t pageCount;
+	};
+
+	struct BakedGlyphPage
+	{
+		std::int32_t size;
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t rows;
+		std::uint32_t flags;
+		std::uint32_t glyphCount;
+		std::uint32_t glyphOffset;
+		std::uint32_t kerningCount;
+		std::uint32_t kerningOffset;
+		std::uint32_t bitmapOffset;
+	};
+
+	struct BakedGlyph
+	{
+		std::uint32_t character;
+		std::uint16_t x, y, width, height;
+		std::int16_t advanceX, advanceY;
+		std::int16_t left, top;
+	};
+
+	struct BakedKerning
+	{
+		std::uint32_t prev;
+		std::uint32_t character;
+		std::int16_t x, y;
+	};
+
+	constexpr std::uint32_t BAKED_GLYPHS_VERSION = 1;
+	constexpr std::uint32_t BAKED_PAGE_KERNING = 1;
+
+	// distance field pages store advances and kerning in 26.6 fixed point
+	constexpr std::uint32_t BAKED_PAGE_DISTANCE_FIELD = 2;
+
+	template <typename T>
+	bool readBaked(const Resource::View& view, std::size_t offset, T *out)
+	{
+		if (offset + sizeof(T) > view.size)
+			return false;
+
+		std::memcpy(out, view.data + offset, sizeof(T));
+		return true;
+	}
+
+	// written by GlyphStore::saveCache, followed by CharacterAtlas::save
+	struct GlyphCacheHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint64_t fontHash;
+		std::int32_t size;
+		std::uint32_t horizontalDpi;
+		std::uint32_t verticalDpi;
+		std::uint32_t flags;
+	};
+
+	constexpr std::uint32_t GLYPH_CACHE_VERSION = 1;
+	constexpr std::uint32_t GLYPH_CACHE_DISTANCE_FIELD = 1;
+
+	// the vita's screen is 960x544 pixels over 4.36x2.45 inches
+	constexpr FT_UInt HORIZONTAL_DPI = 960/4.357877685622746f;
+	constexpr FT_UInt VERTICAL_DPI = 544/2.451306198162795;
+
+	// opening a face per task costs about as much as rasterising a handful
+	// of glyphs, so smaller batches stay on the calling thread
+	constexpr std::size_t PRELOAD_TASK_GLYPHS = 8;
+	constexpr std::size_t PRELOAD_TASKS = 4;
+
+	std::uint64_t kerningKey(unsigned int character, unsigned int prev)
+	{
+		return (static_cast<std::uint64_t>(prev) << 32) | character;
+	}
+
+	// fnv-1a
+	std::uint64_t hash(const Resource::View& view, std::uint64_t hash = 14695981039346656037ull)
+	{
+		for (auto i = 0u; i < view.size; ++i)
+		{
+			hash ^= static_cast<unsigned char>(view.data[i]);
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	// posix renames over the old file in one step. the vita will not rename
+	// on to a file that exists, so there the old one is moved aside and only
+	// removed once the new one is in its place. at no point is there neither
+	// the old file nor a complete temporary one, see GlyphStore::loadCache
+	bool replaceFile(const std::string& from, const std::string& to)
+	{
+		if (std::rename(from.c_str(), to.c_str()) == 0)
+			return true;
+
+		auto old = to + ".old";
+		std::remove(old.c_str());
+
+		if (std::rename(to.c_str(), old.c_str()) != 0)
+			return false;
+
+		if (std::rename(from.c_str(), to.c_str()) != 0)
+		{
+			std::rename(old.c_str(), to.c_str());
+			return false;
+		}
+
+		std::remove(old.c_str());
+		return true;
+	}
+} // anonymous namespace
+
+constexpr float GlyphStore::DISTANCE_FIELD_SIZE;
+
+GlyphStore::GlyphStore(std::shared_ptr<FT_LibraryRec_> library, Resource::View fontData, const Resource::View& bakedGlyphs, float size, bool distanceField)
+	: m_library(std::move(library))
+	, m_fontData(std::move(fontData))
+	, m_size(size)
+	, m_distanceField(distanceField)
+	, m_atlas(distanceField ? GxmTexture::Linear : GxmTexture::Point)
+{
+	if (bakedGlyphs.good)
+	{
+		m_baked = loadBakedGlyphs(bakedGlyphs);
+	}
+}
+
+GlyphStore::~GlyphStore(void)
+{
+	if (m_face)
+	{
+		FT_Done_Face(m_face);
+	}
+}
+
+bool GlyphStore::good(void) const
+{
+	return m_baked || face() != nullptr;
+}
+
+bool GlyphStore::distanceField(void) const
+{
+	return m_distanceField;
+}
+
+bool GlyphStore::kerning(void) const
+{
+	if (m_baked)
+		return m_bakedKerning;
+
+	auto ftFace = face();
+	return ftFace && FT_HAS_KERNING(ftFace);
+}
+
+glm::vec2 GlyphStore::kerningInfo(unsigned int character, unsigned int prev)
+{
+	glm::vec2 info(0, 0);
+
+	if (!kerning())
+		return info;
+
+	// baked pairs, and every other pair once it has been asked for
+	auto key = kerningKey(character, prev);
+	auto it = m_kerning.find(key);
+
+	if (it != m_kerning.end())
+		return it->second;
+
+	// every pair within the baked charset was tabulated, missing ones are 0
+	if (m_bakedCharacters.count(character) && m_bakedCharacters.count(prev))
+	{
+		m_kerning.insert({key, info});
+		return info;
+	}
+
+	auto ftFace = face();
+
+	if (!ftFace)
+		return info;
+
+	FT_Vector dxy;
+	auto prevIndex = glyphIndex(prev);
+	auto index = glyphIndex(character);
+
+	// distance fields are scaled when drawn, so keep the kerning unrounded
+	if (m_distanceField)
+	{
+		FT_Get_Kerning(ftFace, prevIndex, index, FT_KERNING_UNFITTED, &dxy);
+		info = glm::vec2(dxy.x/64.f, dxy.y/64.f);
+	}
+	else
+	{
+		FT_Get_Kerning(ftFace, prevIndex, index, FT_KERNING_DEFAULT, &dxy);
+		info.x = dxy.x >> 6;
+		info.y = dxy.y >> 6;
+	}
+
+	m_kerning.insert({key, info});
+	return info;
+}
+
+GlyphStore::GlyphInfo GlyphStore::glyphInfo(unsigned int character)
+{
+	// resident glyphs are a single lookup of precomputed info
+	if (auto info = m_atlas.find(character))
+		return *info;
+
+	auto ftFace = face();
+
+	if (ftFace)
+	{
+		addGlyph(render(ftFace, character, glyphIndex(character)));
+	}
+
+	return m_atlas.glyphInfo(character);
+}
+
+void GlyphStore::preload(const std::vector<unsigned int>& characters)
+{
+	struct Missing
+	{
+		unsigned int character;
+		unsigned int glyphIndex;
+	};
+
+	std::vector<Missing> missing;
+	std::unordered_set<unsigned int> seen;
+
+	for (auto character : characters)
+	{
+		if (m_atlas.contains(character) || !seen.insert(character).second)
+			continue;
+
+		// the index cache isn't shared with the tasks, so look them up here
+		if (!face())
+			return;
+
+		missing.push_back({character, glyphIndex(character)});
+	}
+
+	if (missing.empty())
+		return;
+
+	auto tasks = std::min(PRELOAD_TASKS, missing.size()/PRELOAD_TASK_GLYPHS);
+	std::vector<std::future<std::vector<RenderedGlyph>>> results;
+	std::vector<RenderedGlyph> rendered;
+
+	// freetype libraries are not thread safe, so every task opens the font
+	// data again in a library of its own. the calling thread takes a share
+	// using the store's face rather than only waiting
+	for (auto task = 1u; task < tasks; ++task)
+	{
+		results.push_back(TaskScheduler::background()->async([this, &missing, task, tasks](void)
+		{
+			std::vector<RenderedGlyph> glyphs;
+			FT_Library library = nullptr;
+
+			if (FT_Init_FreeType(&library))
+				return glyphs;
+
+			if (auto taskFace = openFace(library))
+			{
+				for (auto i = task; i < missing.size(); i += tasks)
+				{
+					glyphs.push_back(render(taskFace, missing[i].character, missing[i].glyphIndex));
+				}
+
+				FT_Done_Face(taskFace);
+			}
+
+			FT_Done_FreeType(library);
+			return glyphs;
+		}));
+	}
+
+	for (auto i = 0u; i < missing.size(); i += std::max<std::size_t>(tasks, 1))
+	{
+		rendered.push_back(render(face(), missing[i].character, missing[i].glyphIndex));
+	}
+
+	for (auto& result : results)
+	{
+		auto glyphs = result.get();
+		std::move(glyphs.begin(), glyphs.end(), std::back_inserter(rendered));
+	}
+
+	// added together, tallest first, as that packs the atlas far more tightly
+	std::stable_sort(rendered.begin(), rendered.end(), [](const RenderedGlyph& a, const RenderedGlyph& b)
+	{
+		return a.rows > b.rows;
+	});
+
+	for (auto& glyph : rendered)
+	{
+		addGlyph(glyph);
+	}
+}
+
+GlyphStore::RenderedGlyph GlyphStore::render(FT_FaceRec_ *face, unsigned int character, unsigned int glyphIndex) const
+{
+	RenderedGlyph rendered{character, {}, 0, 0, glm::vec2(0, 0), 0.f, 0.f};
+
+	// a glyph freetype cannot load is drawn as the font's missing glyph
+	// instead. if even that fails the character takes up no space at all.
+	// this also runs on preload tasks, so nothing is logged
+	if (FT_Load_Glyph(face, glyphIndex, FT_LOAD_DEFAULT) && (!glyphIndex || FT_Load_Glyph(face, 0, FT_LOAD_DEFAULT)))
+		return rendered;
+
+	auto glyph = face->glyph;
+	auto bitmap = &glyph->bitmap;
+
+	// distance fields are scaled when drawn, so keep the advance unrounded
+	if (m_distanceField)
+	{
+		rendered.advance = glm::vec2(glyph->linearHoriAdvance/65536.f, glyph->linearVertAdvance/65536.f);
+	}
+	else
+	{
+		rendered.advance = glm::vec2(glyph->linearHoriAdvance >> 16, glyph->linearVertAdvance >> 16);
+	}
+
+	// one that loads but will not render still moves the text along
+	if (FT_Render_Glyph(glyph, FT_RENDER_MODE_NORMAL))
+		return rendered;
+
+	rendered.left = glyph->bitmap_left;
+	rendered.top = glyph->bitmap_top;
+
+	if (!m_distanceField)
+	{
+		rendered.width = bitmap->width;
+		rendered.rows = bitmap->rows;
+		rendered.bitmap.resize(bitmap->width*bitmap->rows);
+
+		for (auto y = 0u; y < bitmap->rows; ++y)
+		{
+			std::memcpy(rendered.bitmap.data() + y*bitmap->width, bitmap->buffer + y*bitmap->pitch, bitmap->width);
+		}
+
+		return rendered;
+	}
+
+	// nothing to draw, but the advance is still needed
+	if (!bitmap->width || !bitmap->rows)
+		return rendered;
+
+	rendered.bitmap = DistanceField::generate(bitmap->buffer, bitmap->width, bitmap->rows, bitmap->pitch);
+	rendered.width = bitmap->width + 2*DistanceField::SPREAD;
+	rendered.rows = bitmap->rows + 2*DistanceField::SPREAD;
+	rendered.left -= DistanceField::SPREAD;
+	rendered.top += DistanceField::SPREAD;
+	return rendered;
+}
+
+bool GlyphStore::addGlyph(const RenderedGlyph& glyph)
+{
+	return m_atlas.addGlyph
+	(
+		glyph.character,
+		glyph.bitmap.data(),
+		glyph.width,
+		glyph.rows,
+		glyph.width,
+		glyph.advance,
+		glyph.left,
+		glyph.top
+	);
+}
+
+bool GlyphStore::loadCache(const std::string& filename, std::uint64_t fontHash)
+{
+	m_cacheFile = filename;
+	m_cacheHash = fontHash;
+	m_cacheRasterizations = m_quietRasterizations = m_atlas.statistics().rasterizations;
+
+	// the whole file in one read. a save cut short between moving the old
+	// file aside and renaming the new one leaves only the temporary file,
+	// which is complete by then
+	auto file = Resource::readFilesystem(filename);
+
+	if (!file.good)
+	{
+		file = Resource::readFilesystem(filename + ".tmp");
+	}
+
+	GlyphCacheHeader header;
+
+	if (!file.good || file.data.size() < sizeof(header))
+		return false;
+
+	std::memcpy(&header, file.data.data(), sizeof(header));
+
+	if (std::memcmp(header.magic, "RGLC", 4) != 0
+		|| header.version != GLYPH_CACHE_VERSION
+		|| header.fontHash != fontHash
+		|| header.size != static_cast<std::int32_t>(m_size*64)
+		|| header.horizontalDpi != HORIZONTAL_DPI
+		|| header.verticalDpi != VERTICAL_DPI
+		|| header.flags != (m_distanceField ? GLYPH_CACHE_DISTANCE_FIELD : 0))
+		return false;
+
+	return m_atlas.load(file.data.data() + sizeof(header), file.data.size() - sizeof(header));
+}
+
+void GlyphStore::saveCache(void)
+{
+	if (m_cacheFile.empty())
+		return;
+
+	auto rasterizations = m_atlas.statistics().rasterizations;
+	auto quiet = rasterizations == m_quietRasterizations;
+	m_quietRasterizations = rasterizations;
+
+	// wait for a burst of rasterising to finish rather than writing the
+	// atlas after every few glyphs
+	if (!quiet || rasterizations == m_cacheRasterizations)
+		return;
+
+	// the previous write is still going, try again next time
+	if (m_cacheWrite.valid() && m_cacheWrite.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return;
+
+	GlyphCacheHeader header
+	{
+		{'R', 'G', 'L', 'C'},
+		GLYPH_CACHE_VERSION,
+		m_cacheHash,
+		static_cast<std::int32_t>(m_size*64),
+		HORIZONTAL_DPI,
+		VERTICAL_DPI,
+		m_distanceField ? GLYPH_CACHE_DISTANCE_FIELD : 0
+	};
+
+	auto atlas = m_atlas.save();
+	std::vector<char> data(sizeof(header) + atlas.size());
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), atlas.data(), atlas.size());
+
+	m_cacheRasterizations = rasterizations;
+
+	m_cacheWrite = TaskScheduler::background()->async([filename = m_cacheFile, data = std::move(data)](void)
+	{
+		// written alongside and then moved over the old file. a launch that
+		// finds a partial file rejects it and rasterises as usual
+		auto temporary = filename + ".tmp";
+
+		{
+			std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+			file.write(data.data(), data.size());
+
+			if (!file.good())
+			{
+				file.close();
+				std::remove(temporary.c_str());
+				return;
+			}
+		}
+
+		// the old file is kept if the new one cannot replace it
+		if (!replaceFile(temporary, filename))
+		{
+			std::remove(temporary.c_str());
+		}
+	});
+}
+
+bool GlyphStore::loadBakedGlyphs(const Resource::View& bakedGlyphs)
+{
+	BakedGlyphsHeader header;
+
+	if (!readBaked(bakedGlyphs, 0, &header) || std::memcmp(header.magic, "RGLY", 4) != 0 || header.version != BAKED_GLYPHS_VERSION)
+		return false;
+
+	// match the 26.6 size freetype would have been given
+	auto size = static_cast<std::int32_t>(m_size*64);
+
+	for (auto i = 0u; i < header.pageCount; ++i)
+	{
+		BakedGlyphPage page;
+
+		if (!readBaked(bakedGlyphs, sizeof(header) + i*sizeof(page), &page))
+			return false;
+
+		auto distanceField = (page.flags & BAKED_PAGE_DISTANCE_FIELD) != 0;
+
+		if (page.size != size || distanceField != m_distanceField)
+			continue;
+
+		auto unit = distanceField ? 64.f : 1.f;
+
+		if (page.bitmapOffset + page.width*page.rows > bakedGlyphs.size)
+			return false;
+
+		if (!m_atlas.setBakedPage(bakedGlyphs.data + page.bitmapOffset, page.width, page.rows))
+			return false;
+
+		for (auto g = 0u; g < page.glyphCount; ++g)
+		{
+			BakedGlyph glyph;
+
+			if (!readBaked(bakedGlyphs, page.glyphOffset + g*sizeof(glyph), &glyph))
+				return false;
+
+			m_atlas.addBakedGlyph
+			(
+				glyph.character,
+				TextureAtlas::AtlasRegion(glyph.x, glyph.y, glyph.width, glyph.height),
+				glm::vec2(glyph.advanceX, glyph.advanceY)/unit,
+				glyph.left,
+				glyph.top
+			);
+
+			m_bakedCharacters.insert(glyph.character);
+		}
+
+		for (auto k = 0u; k < page.kerningCount; ++k)
+		{
+			BakedKerning kerning;
+
+			if (!readBaked(bakedGlyphs, page.kerningOffset + k*sizeof(kerning), &kerning))
+				return false;
+
+			m_kerning.insert({kerningKey(kerning.character, kerning.prev), glm::vec2(kerning.x, kerning.y)/unit});
+		}
+
+		m_bakedKerning = (page.flags & BAKED_PAGE_KERNING) != 0;
+		return true;
+	}
+
+	return false;
+}
+
+unsigned int GlyphStore::glyphIndex(unsigned int character)
+{
+	auto it = m_glyphIndices.find(character);
+
+	if (it != m_glyphIndices.end())
+		return it->second;
+
+	// evicted glyphs are rasterised again, and kerning wants both of a pair
+	auto index = FT_Get_Char_Index(face(), character);
+	m_glyphIndices.insert({character, index});
+	return index;
+}
+
+FT_FaceRec_ *GlyphStore::openFace(FT_LibraryRec_ *library) const
+{
+	FT_Face face = nullptr;
+
+	// embedded fonts are used in place, so the face reads straight from the
+	// executable image rather than a heap copy of the file
+	auto data = reinterpret_cast<const FT_Byte *>(m_fontData.data);
+
+	if (FT_New_Memory_Face(library, data, m_fontData.size, 0, &face))
+		return nullptr;
+
+	FT_Set_Char_Size(face, 0, FT_F26Dot6(m_size*64), HORIZONTAL_DPI, VERTICAL_DPI);
+	return face;
+}
+
+FT_FaceRec_ *GlyphStore::face(void) const
+{
+	if (m_faceOpened)
+		return m_face;
+
+	m_faceOpened = true;
+	m_face = openFace(m_library.get());
+	return m_face;
+}
+
+CharacterAtlas *GlyphStore::atlas(void)
+{
+	return &m_atlas;
+}
+
+FontCache::FontCache(void)
+{
+	FT_Library library = nullptr;
+	FT_Init_FreeType(&library);
+	m_library.reset(library, FT_Done_FreeType);
+}
+
+FontCache::~FontCache(void)
+{
+}
+
+FontCache *FontCache::instance(void)
+{
+	static FontCache cache;
+	return &cache;
+}
+
+void FontCache::setCacheDirectory(const std::string& directory)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// fails harmlessly when it already exists
+	mkdir(directory.c_str(), 0777);
+	m_cacheDirectory = directory;
+}
+
+void FontCache::nextFrame(float dt)
+{
+	CharacterAtlas::nextFrame();
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::size_t uploadedBytes = 0;
+
+		for (auto& store : m_stores)
+		{
+			// the frame's text has all been drawn, so glyphs can move now
+			store.second->atlas()->collect();
+			uploadedBytes += store.second->atlas()->uploadedBytes();
+		}
+
+		m_uploadedBytesPerFrame = uploadedBytes - m_uploadedBytes;
+		m_uploadedBytes = uploadedBytes;
+	}
+
+	m_rateElapsed += dt;
+
+	if (m_rateElapsed < 1.f)
+		return;
+
+	auto rasterizations = statistics().rasterizations;
+	m_rasterizationsPerSecond = (rasterizations - m_rateRasterizations)/m_rateElapsed;
+	m_rateRasterizations = rasterizations;
+	m_rateElapsed = 0.f;
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (auto& store : m_stores)
+	{
+		store.second->saveCache();
+	}
+}
+
+FontCache::Statistics FontCache::statistics(void)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	Statistics statistics{0, 0, 0.f, 0, 0, m_rasterizationsPerSecond, 0, m_uploadedBytesPerFrame};
+	float usedPages = 0.f;
+
+	for (auto& store : m_stores)
+	{
+		auto atlas = store.second->atlas()->statistics();
+		statistics.pages += atlas.pages;
+		statistics.glyphs += atlas.glyphs;
+		statistics.evictions += atlas.evictions;
+		statistics.rasterizations += atlas.rasterizations;
+		statistics.uploadedBytes += atlas.uploadedBytes;
+		usedPages += atlas.occupancy*atlas.pages;
+	}
+
+	if (statistics.pages)
+	{
+		statistics.occupancy = usedPages/statistics.pages;
+	}
+
+	return statistics;
+}
+
+std::uint64_t FontCache::fontHash(const std::string& file, const Resource::View& data, const Resource::View& baked)
+{
+	auto it = m_fontHashes.find(file);
+
+	if (it != m_fontHashes.end())
+		return it->second;
+
+	auto value = hash(baked, hash(data));
+	m_fontHashes.insert({file, value});
+	return value;
+}
+
+Resource::View FontCache::fontData(const std::string& file)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_fontData.find(file);
+
+	if (it != m_fontData.end())
+		return it->second;
+
+	auto data = Resource::view(file);
+
+	if (!data.good)
+		return data;
+
+	m_fontData.insert({file, data});
+	return data;
+}
+
+Resource::View FontCache::bakedGlyphs(const std::string& file)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	auto it = m_bakedGlyphs.find(file);
+
+	if (it != m_bakedGlyphs.end())
+		return it->second;
+
+	// tools/glyphbake.py writes fonts/X.ttf as fonts/X.glyphs. fonts without
+	// baked glyphs are remembered too so we only look once
+	auto name = file.substr(0, file.find_last_of('.')) + ".glyphs";
+	auto data = Resource::view(name);
+
+	m_bakedGlyphs.insert({file, data});
+	return data;
+}
+
+std::shared_ptr<GlyphStore> FontCache::glyphStore(const std::string& file, float size, bool distanceField)
+{
+	auto data = fontData(file);
+
+	if (!data.good)
+		return nullptr;
+
+	auto baked = bakedGlyphs(file);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// key on the 26.6 size freetype actually sees so 12.f and 12.001f share
+	StoreKey key{file, static_cast<long>(size*64), distanceField};
+	auto it = m_stores.find(key);
+
+	if (it != m_stores.end())
+		return it->second;
+
+	auto cacheHash = m_cacheDirectory.empty() ? 0 : fontHash(file, data, baked);
+	auto store = std::make_shared<GlyphStore>(m_library, std::move(data), baked, size, distanceField);
+
+	if (!store->good())
+		return nullptr;
+
+	if (!m_cacheDirectory.empty())
+	{
+		// the hash covers the font and its baked glyphs, so a new build with
+		// either changed never picks up an old cache
+		char name[64];
+		std::snprintf(name, sizeof(name), "/%016llx-%ld%s.glyphcache", static_cast<unsigned long long>(cacheHash), std::get<1>(key), distanceField ? "-sdf" : "");
+		store->loadCache(m_cacheDirectory + name, cacheHash);
+	}
+
+	// stores are kept for the lifetime of the application. pages come and go
+	// but the glyphs they rendered are very likely to be needed again
+	m_stores.insert({key, store});
+	return store;
+}
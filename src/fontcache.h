@@ -0,0 +1,176 @@
+/*
+ * fontcache.h - process-wide cache of font faces and glyph stores
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef FONTCACHE_H
+#define FONTCACHE_H
+
+#include "characteratlas.h"
+#include "resource.h"
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+struct FT_FaceRec_;
+struct FT_LibraryRec_;
+
+// a face opened at a single point size along with the atlas of every glyph
+// rendered from it. these are shared between all fonts of the same file and
+// size, so the atlas only exists once regardless of how many labels use it.
+// when the build baked glyphs for this size the atlas starts from those, and
+// the face is only opened if a glyph outside the baked charset is needed.
+// a distance field store keeps a signed distance field of each glyph instead
+// of its bitmap, which can be drawn at any size. its metrics are fractional
+class GlyphStore
+{
+public:
+	using GlyphInfo = CharacterAtlas::GlyphInfo;
+
+	// the size distance field glyphs are rendered at, whatever size they are
+	// drawn at. assets/CMakeLists.txt bakes a page for this size
+	static constexpr float DISTANCE_FIELD_SIZE = 16.f;
+
+public:
+	GlyphStore(std::shared_ptr<FT_LibraryRec_> library, Resource::View fontData, const Resource::View& bakedGlyphs, float size, bool distanceField);
+	~GlyphStore(void);
+
+	GlyphStore(const GlyphStore&) = delete;
+	GlyphStore& operator=(const GlyphStore&) = delete;
+
+	bool good(void) const;
+	bool distanceField(void) const;
+	bool kerning(void) const;
+	glm::vec2 kerningInfo(unsigned int character, unsigned int prev);
+
+	GlyphInfo glyphInfo(unsigned int character);
+	CharacterAtlas *atlas(void);
+
+	// rasterises every character not yet in the atlas before adding them all.
+	// larger batches are spread over the background scheduler, each task
+	// with a face of its own on the same font data
+	void preload(const std::vector<unsigned int>& characters);
+
+	// restores the atlas a previous launch saved to filename, as long as it
+	// was saved from the same font data, size and resolution. saveCache
+	// writes the atlas back there once rasterising has been quiet since the
+	// previous call, on the background scheduler
+	bool loadCache(const std::string& filename, std::uint64_t fontHash);
+	void saveCache(void);
+
+private:
+	struct RenderedGlyph
+	{
+		unsigned int character;
+		std::vector<char> bitmap;
+		std::size_t width;
+		std::size_t rows;
+		glm::vec2 advance;
+		float left;
+		float top;
+	};
+
+private:
+	RenderedGlyph render(FT_FaceRec_ *face, unsigned int character, unsigned int glyphIndex) const;
+	bool addGlyph(const RenderedGlyph& glyph);
+	bool loadBakedGlyphs(const Resource::View& bakedGlyphs);
+	unsigned int glyphIndex(unsigned int character);
+	FT_FaceRec_ *openFace(FT_LibraryRec_ *library) const;
+	FT_FaceRec_ *face(void) const;
+
+private:
+	// the face must be released before the library it was created from
+	std::shared_ptr<FT_LibraryRec_> m_library;
+	Resource::View m_fontData;
+	float m_size;
+	bool m_distanceField;
+	mutable FT_FaceRec_ *m_face{nullptr};
+	mutable bool m_faceOpened{false};
+	CharacterAtlas m_atlas;
+
+	bool m_baked{false};
+	bool m_bakedKerning{false};
+	std::unordered_set<unsigned int> m_bakedCharacters;
+	std::unordered_map<std::uint64_t, glm::vec2> m_kerning;
+	std::unordered_map<unsigned int, unsigned int> m_glyphIndices;
+
+	std::string m_cacheFile;
+	std::uint64_t m_cacheHash{0};
+	unsigned int m_cacheRasterizations{0};
+	unsigned int m_quietRasterizations{0};
+	std::future<void> m_cacheWrite;
+};
+
+class FontCache
+{
+public:
+	// totals across the atlases of every glyph store
+	struct Statistics
+	{
+		std::size_t pages;
+		std::size_t glyphs;
+		float occupancy;
+		unsigned int evictions;
+		unsigned int rasterizations;
+		float rasterizationsPerSecond;
+		std::size_t uploadedBytes;
+		std::size_t uploadedBytesPerFrame;
+	};
+
+public:
+	static FontCache *instance(void);
+
+	// glyph atlases are saved here and restored by the next launch, so
+	// glyphs are only rasterised once. empty, the default, disables this
+	void setCacheDirectory(const std::string& directory);
+
+	// call once per frame, after the frame's text has been drawn. atlases
+	// that ran out of room make it here
+	void nextFrame(float dt);
+	Statistics statistics(void);
+
+	Resource::View fontData(const std::string& file);
+	Resource::View bakedGlyphs(const std::string& file);
+	std::shared_ptr<GlyphStore> glyphStore(const std::string& file, float size, bool distanceField = false);
+
+private:
+	FontCache(void);
+	~FontCache(void);
+
+private:
+	std::uint64_t fontHash(const std::string& file, const Resource::View& data, const Resource::View& baked);
+
+private:
+	using StoreKey = std::tuple<std::string, long, bool>;
+
+	std::mutex m_mutex;
+	std::shared_ptr<FT_LibraryRec_> m_library;
+	std::map<std::string, Resource::View> m_fontData;
+	std::map<std::string, Resource::View> m_bakedGlyphs;
+	std::map<StoreKey, std::shared_ptr<GlyphStore>> m_stores;
+	std::string m_cacheDirectory;
+	std::map<std::string, std::uint64_t> m_fontHashes;
+
+	float m_rateElapsed{0.f};
+	unsigned int m_rateRasterizations{0};
+	float m_rasterizationsPerSecond{0.f};
+	std::size_t m_uploadedBytes{0};
+	std::size_t m_uploadedBytesPerFrame{0};
+};
+
+#endif // FONTCACHE_H
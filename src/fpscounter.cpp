@@ -8,16 +8,18 @@
  */
 
 #include "fpscounter.h"
+#include "vertextypes.h"
 
-#include <sstream>
-#include <iomanip>
+#include <cstdio>
 
 FpsCounter::FpsCounter(GxmShaderPatcher *patcher)
 	: m_font("rsc:/fonts/DroidSans.ttf")
 	, m_fpsText(&m_font, "FPS: 00.00")
 	, m_renderer(patcher)
 {
-	m_renderer.setShaders<ColouredTextureVertex>("rsc:/backgroundtext.vert.cg.gxp", "rsc:/backgroundtext.frag.cg.gxp");
+	m_renderer.setShaders<TextVertex>("rsc:/backgroundtext.vert.cg.gxp"_rsc, "rsc:/backgroundtext.frag.cg.gxp"_rsc);
+	m_fpsText.setDynamic(true);
+	m_fpsText.setColour(glm::vec4(0.f, 0.f, 0.f, 1.f));
 }
 
 void FpsCounter::setModel(glm::mat4 model)
@@ -39,10 +41,10 @@ void FpsCounter::update(float dt)
 {
 	m_fps = (m_fps * smoothingRatio) + (dt * (1.f - smoothingRatio));
 
-	std::stringstream stream;
-	stream << "FPS: " << std::fixed << std::setprecision(2) << (1.f/m_fps);
-	m_fpsText.setText(stream.str());
-	m_fpsText.setColour(glm::vec4(0.f, 0.f, 0.f, 1.f));
+	// formatted without a stream so an update allocates nothing
+	char text[32];
+	std::snprintf(text, sizeof(text), "FPS: %.2f", 1.f/m_fps);
+	m_fpsText.setText(text);
 }
 
 void FpsCounter::draw(SceGxmContext *ctx, const Camera *camera)
@@ -25,7 +25,7 @@ void GeometryRenderer::setBlendInfo(SceGxmBlendInfo *blendInfo)
 	m_program.setBlendInfo(blendInfo);
 }
 
-void GeometryRenderer::readShaders(const std::string& vertexShader, const std::string& fragmentShader)
+void GeometryRenderer::readShaders(ResourceFactory::Name vertexShader, ResourceFactory::Name fragmentShader)
 {
 	ShaderUtility::read(vertexShader, &m_vertexShader);
 	ShaderUtility::read(fragmentShader, &m_fragmentShader);
@@ -42,3 +42,11 @@ void GeometryRenderer::draw(SceGxmContext *ctx, const Camera *camera, const Geom
 
 	geometry->draw(ctx, this, camera);
 }
+
+void GeometryRenderer::setColour(const glm::vec4& colour) const
+{
+	if (!m_colourIndex)
+		return;
+
+	m_vertexShader.setUniformValue(m_colourIndex, colour.r, colour.g, colour.b, colour.a);
+}
@@ -10,10 +10,14 @@
 #ifndef GEOMETRYRENDERER_H
 #define GEOMETRYRENDERER_H
 
+#include "resource.h"
+
 #include <framework/gxmshaderprogram.h>
 #include <framework/gxmvertexshader.h>
 #include <framework/gxmfragmentshader.h>
 
+#include <glm/vec4.hpp>
+
 class Geometry;
 class Camera;
 
@@ -24,22 +28,27 @@ public:
 
 	void setBlendInfo(SceGxmBlendInfo *blendInfo);
 
+	// embedded shader programs, eg. "rsc:/colour.vert.cg.gxp"_rsc
 	template <typename Vertex>
-	void setShaders(const std::string& vertexShader, const std::string& fragmentShader);
+	void setShaders(ResourceFactory::Name vertexShader, ResourceFactory::Name fragmentShader);
 	void draw(SceGxmContext *ctx, const Camera *camera, const Geometry *geometry) const;
 
+	// only for shaders with a colour uniform, call from Geometry::doDraw
+	void setColour(const glm::vec4& colour) const;
+
 private:
-	void readShaders(const std::string& vertexShader, const std::string& fragmentShader);
+	void readShaders(ResourceFactory::Name vertexShader, ResourceFactory::Name fragmentShader);
 
 private:
 	GxmShaderProgram m_program;
 	mutable GxmVertexShader m_vertexShader;
 	GxmFragmentShader m_fragmentShader;
 	GxmShader::UniformIndex m_mvpIndex;
+	GxmShader::UniformIndex m_colourIndex{nullptr};
 };
 
 template <typename Vertex>
-void GeometryRenderer::setShaders(const std::string& vertexShader, const std::string& fragmentShader)
+void GeometryRenderer::setShaders(ResourceFactory::Name vertexShader, ResourceFactory::Name fragmentShader)
 {
 	// read shaders
 	readShaders(vertexShader, fragmentShader);
@@ -48,6 +57,7 @@ void GeometryRenderer::setShaders(const std::string& vertexShader, const std::st
 	m_program.addShader(&m_fragmentShader);
 
 	m_mvpIndex = m_vertexShader.uniformIndex("mvp");
+	m_colourIndex = m_vertexShader.uniformIndex("colour");
 
 	auto attributes = Vertex::attributes(&m_vertexShader);
 	auto streams = Vertex::streams();
@@ -21,6 +21,7 @@
 #include "successpage.h"
 #include "failurepage.h"
 #include "easingcurves.h"
+#include "fontcache.h"
 
 #include <framework/task.h>
 #include <framework/buttonevent.h>
@@ -173,6 +174,8 @@ void InstallerView::render(SceGxmContext *ctx)
 	{
 		page->draw(ctx, m_camera);
 	}
+
+	FontCache::instance()->nextFrame(m_dt);
 }
 
 bool InstallerView::isTransitioning(void) const
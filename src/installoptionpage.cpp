@@ -27,6 +27,9 @@ InstallOptionPage::InstallOptionPage(GxmShaderPatcher *patcher)
 	m_font18.setPointSize(18.f);
 	m_font16.setPointSize(12.f);
 	m_font8.setPointSize(8.f);
+	m_font18.setDistanceField(true);
+	m_font16.setDistanceField(true);
+	m_font8.setDistanceField(true);
 	
 	m_rectangle.setColour(glm::vec4(0.f, 0.f, 0.f, 0.5f));
 	m_selectionBox.setColour(glm::vec4(0.3f, 1.f, 0.2f, 0.2f));
@@ -79,10 +82,10 @@ InstallOptionPage::InstallOptionPage(GxmShaderPatcher *patcher)
 	blendInfo.colorMask = SCE_GXM_COLOR_MASK_ALL;
 
 	m_renderer.setBlendInfo(&blendInfo);
-	m_renderer.setShaders<ColouredGeometryVertex>("rsc:/colour.vert.cg.gxp", "rsc:/colour.frag.cg.gxp");
+	m_renderer.setShaders<CompactGeometryVertex>("rsc:/compactcolour.vert.cg.gxp"_rsc, "rsc:/colour.frag.cg.gxp"_rsc);
 
 	m_textRenderer.setBlendInfo(&blendInfo);
-	m_textRenderer.setShaders<ColouredTextureVertex>("rsc:/text.vert.cg.gxp", "rsc:/text.frag.cg.gxp");
+	m_textRenderer.setShaders<TextVertex>("rsc:/text.vert.cg.gxp"_rsc, "rsc:/sdftext.frag.cg.gxp"_rsc);
 }
 
 void InstallOptionPage::onModelChanged(glm::mat4 model)
@@ -45,8 +45,8 @@ private:
 	void positionComponents(void);
 
 private:
-	RoundedRectangle<ColouredGeometryVertex> m_rectangle;
-	Rectangle<ColouredGeometryVertex> m_selectionBox;
+	RoundedRectangle<CompactGeometryVertex> m_rectangle;
+	Rectangle<CompactGeometryVertex> m_selectionBox;
 	GeometryRenderer m_renderer, m_textRenderer;
 	Font m_font18, m_font16, m_font8;
 	Text m_titleText, m_simpleInstallationText, m_simpleInstallationDesc, m_customInstallationText, m_customInstallationDesc, m_nextPageDirection;
@@ -22,6 +22,8 @@ InstallPage::InstallPage(GxmShaderPatcher *patcher)
 {
 	m_font20.setPointSize(20.f);
 	m_font12.setPointSize(12.f);
+	m_font20.setDistanceField(true);
+	m_font12.setDistanceField(true);
 	
 	m_rectangle.setColour(glm::vec4(0.f, 0.f, 0.f, 0.5f));
 
@@ -46,10 +48,10 @@ InstallPage::InstallPage(GxmShaderPatcher *patcher)
 	blendInfo.colorMask = SCE_GXM_COLOR_MASK_ALL;
 
 	m_renderer.setBlendInfo(&blendInfo);
-	m_renderer.setShaders<ColouredGeometryVertex>("rsc:/colour.vert.cg.gxp", "rsc:/colour.frag.cg.gxp");
+	m_renderer.setShaders<CompactGeometryVertex>("rsc:/compactcolour.vert.cg.gxp"_rsc, "rsc:/colour.frag.cg.gxp"_rsc);
 
 	m_textRenderer.setBlendInfo(&blendInfo);
-	m_textRenderer.setShaders<ColouredTextureVertex>("rsc:/text.vert.cg.gxp", "rsc:/text.frag.cg.gxp");
+	m_textRenderer.setShaders<TextVertex>("rsc:/text.vert.cg.gxp"_rsc, "rsc:/sdftext.frag.cg.gxp"_rsc);
 }
 
 void InstallPage::onModelChanged(glm::mat4 model)
@@ -28,7 +28,7 @@ private:
 	void onModelChanged(glm::mat4 model) final;
 
 private:
-	RoundedRectangle<ColouredGeometryVertex> m_rectangle;
+	RoundedRectangle<CompactGeometryVertex> m_rectangle;
 	GeometryRenderer m_renderer, m_textRenderer;
 	Font m_font20, m_font12;
 	Text m_welcomeText, m_nextPageDirection;
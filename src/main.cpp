@@ -1,4 +1,5 @@
 #include "installerview.h"
+#include "fontcache.h"
 
 #include <framework/guiapplication.h>
 #include <framework/view.h>
@@ -38,6 +39,8 @@ int main(int argc, char *argv[])
 {
 	LOG(INFO) << "starting installer";
 
+	FontCache::instance()->setCacheDirectory("ux0:data/henkaku_installer");
+
 	GuiApplication app(argc, argv);
 	{
 		auto view = std::make_shared<InstallerView>();
@@ -10,10 +10,13 @@
 #ifndef RECTANGLE_H
 #define RECTANGLE_H
 
-#include <framework/gpumemoryblock.h>
+#include <framework/framering.h>
+#include <framework/quadindexbuffer.h>
 
 #include <glm/gtx/transform.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include "geometry.h"
 
@@ -49,13 +52,9 @@ private:
 	void doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const override;
 
 private:
-	std::unique_ptr<GpuMemoryBlock<Vertex>> m_vertices;
-	std::unique_ptr<GpuMemoryBlock<uint16_t>> m_indices;
-
-	Vertex *m_topLeft;
-	Vertex *m_topRight;
-	Vertex *m_bottomLeft;
-	Vertex *m_bottomRight;
+	// bottom left, bottom right, top left, top right. these are copied to
+	// the frame ring each draw, so they can change while on screen
+	Vertex m_vertices[4]{};
 
 	float m_width, m_height;
 	glm::mat4 m_model;
@@ -65,34 +64,10 @@ private:
 template <typename Vertex>
 Rectangle<Vertex>::Rectangle(void)
 {
-	m_vertices = std::make_unique<GpuMemoryBlock<Vertex>>
-	(
-		4,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_indices = std::make_unique<GpuMemoryBlock<uint16_t>>
-	(
-		6,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_bottomLeft = &m_vertices->address()[0];
-	m_bottomRight = &m_vertices->address()[1];
-	m_topLeft = &m_vertices->address()[2];
-	m_topRight = &m_vertices->address()[3];
-	
-	m_bottomLeft->position = glm::vec3(-1, -1, 0);
-	m_bottomRight->position = glm::vec3(1, -1, 0);
-	m_topLeft->position = glm::vec3(-1, 1, 0);
-	m_topRight->position = glm::vec3(1, 1, 0);
-
-	m_indices->address()[0] = 0;
-	m_indices->address()[1] = 1;
-	m_indices->address()[2] = 2;
-	m_indices->address()[3] = 1;
-	m_indices->address()[4] = 3;
-	m_indices->address()[5] = 2;
+	m_vertices[0].position = glm::vec3(-1, -1, 0);
+	m_vertices[1].position = glm::vec3(1, -1, 0);
+	m_vertices[2].position = glm::vec3(-1, 1, 0);
+	m_vertices[3].position = glm::vec3(1, 1, 0);
 
 	setWidth(1.f);
 	setHeight(1.f);
@@ -133,48 +108,49 @@ template <typename Vertex>
 template <typename Colour>
 void Rectangle<Vertex>::setBottomLeftColour(Colour colour)
 {
-	m_bottomLeft->colour = colour;
+	m_vertices[0].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void Rectangle<Vertex>::setBottomRightColour(Colour colour)
 {
-	m_bottomRight->colour = colour;
+	m_vertices[1].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void Rectangle<Vertex>::setTopLeftColour(Colour colour)
 {
-	m_topLeft->colour = colour;
+	m_vertices[2].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void Rectangle<Vertex>::setTopRightColour(Colour colour)
 {
-	m_topRight->colour = colour;
+	m_vertices[3].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void Rectangle<Vertex>::setColour(Colour colour)
 {
-	auto vertices = m_vertices->address();
-
 	// apply colour to all vertices
-	for (auto i = 0u; i < m_vertices->count(); ++i)
+	for (auto& vertex : m_vertices)
 	{
-		vertices[i].colour = colour;
+		vertex.colour = colour;
 	}
 }
 
 template <typename Vertex>
 void Rectangle<Vertex>::doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const
 {
-	sceGxmSetVertexStream(ctx, 0, m_vertices->address());
-	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, m_indices->address(), m_indices->count());
+	auto vertices = FrameRing::instance()->allocate<Vertex>(4);
+	std::copy(std::begin(m_vertices), std::end(m_vertices), vertices);
+
+	sceGxmSetVertexStream(ctx, 0, vertices);
+	QuadIndexBuffer::instance()->draw(ctx, 0, 1);
 }
 
 #endif // RECTANGLE_H
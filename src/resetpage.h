@@ -34,7 +34,7 @@ private:
 	void positionComponents(void);
 
 private:
-	RoundedRectangle<ColouredGeometryVertex> m_rectangle;
+	RoundedRectangle<CompactGeometryVertex> m_rectangle;
 	GeometryRenderer m_renderer, m_textRenderer;
 	Font m_font20, m_font12, m_font8;
 	Text m_titleText, m_description, m_description2, m_description3, m_nextPageDirection, m_checkBoxLabel;
@@ -8,40 +8,163 @@
  */
 
 #include "resource.h"
-#include <generatedresources.h>
+
+#include <framework/taskscheduler.h>
+
+#include <miniz.h>
 
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <list>
+#include <mutex>
 
 using namespace Resource;
 
-File Resource::read(const std::string& filename)
+namespace
 {
-	std::string prefix("rsc:");
-	
-	// check if there is a rsc prefix
-	if (filename.compare(0, prefix.length(), prefix) == 0)
+	// inflated resources are kept around after use until the cache grows
+	// beyond this, then the least recently used that are not being viewed
+	// are released
+	constexpr std::size_t INFLATE_CACHE_BUDGET = 1024*1024;
+
+	class InflateCache
 	{
-		return readResource(filename);
+	public:
+		static InflateCache *instance(void)
+		{
+			static InflateCache cache;
+			return &cache;
+		}
+
+		std::shared_ptr<const std::vector<char>> inflate(const ResourceFactory::Resource *res)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+			{
+				if (it->resource == res)
+				{
+					m_entries.splice(m_entries.begin(), m_entries, it);
+					return it->data;
+				}
+			}
+
+			auto data = std::make_shared<std::vector<char>>(res->rawSize);
+			auto size = tinfl_decompress_mem_to_mem(data->data(), data->size(), res->data, res->size, 0);
+
+			if (size != res->rawSize)
+				return nullptr;
+
+			m_entries.push_front({ res, data });
+			m_size += data->size();
+			evict();
+			return data;
+		}
+
+	private:
+		struct Entry
+		{
+			const ResourceFactory::Resource *resource;
+			std::shared_ptr<const std::vector<char>> data;
+		};
+
+		void evict(void)
+		{
+			for (auto it = m_entries.rbegin(); it != m_entries.rend() && m_size > INFLATE_CACHE_BUDGET;)
+			{
+				// anything still being viewed stays, we would only inflate it again
+				if (it->data.use_count() > 1)
+				{
+					++it;
+					continue;
+				}
+
+				m_size -= it->data->size();
+				it = decltype(it)(m_entries.erase(std::next(it).base()));
+			}
+		}
+
+		std::mutex m_mutex;
+		std::list<Entry> m_entries;
+		std::size_t m_size{0};
+	};
+
+	View viewOf(const ResourceFactory::Resource *res)
+	{
+		View view;
+
+		if (!res)
+			return view;
+
+		if (res->compressed)
+		{
+			auto storage = InflateCache::instance()->inflate(res);
+
+			if (!storage)
+				return view;
+
+			view.data = storage->data();
+			view.size = storage->size();
+			view.storage = std::move(storage);
+		}
+		else
+		{
+			view.data = res->data;
+			view.size = res->size;
+		}
+
+		view.good = true;
+		return view;
 	}
-	else if (filename.find(':') == std::string::npos)
+
+	enum class Source
 	{
-		return readFilesystem("app0:/" + filename);
+		Resource,
+		Filesystem,
+		Application
+	};
+
+	Source source(const std::string& filename)
+	{
+		std::string prefix("rsc:");
+
+		// check if there is a rsc prefix
+		if (filename.compare(0, prefix.length(), prefix) == 0)
+		{
+			return Source::Resource;
+		}
+		else if (filename.find(':') == std::string::npos)
+		{
+			return Source::Application;
+		}
+
+		return Source::Filesystem;
 	}
+}
 
-	return readFilesystem(filename);
+File Resource::read(const std::string& filename)
+{
+	switch (source(filename))
+	{
+	case Source::Resource:
+		return readResource(filename);
+	case Source::Application:
+		return readFilesystem("app0:/" + filename);
+	case Source::Filesystem:
+	default:
+		return readFilesystem(filename);
+	}
 }
 
 File Resource::readResource(const std::string& filename)
 {
 	File file;
-	auto res = ResourceFactory::find(filename);
+	auto res = viewResource(filename);
 
-	if (res)
+	if (res.good)
 	{
-		file.data.resize(res->size);
-		std::memcpy(file.data.data(), res->data, res->size);
+		file.data.assign(res.data, res.data+res.size);
 		file.good = true;
 	}
 
@@ -52,6 +175,12 @@ File Resource::readFilesystem(const std::string& filename)
 {
 	File resource;
 	std::ifstream file(filename, std::ios::binary | std::ios::ate);
+
+	if (!file.is_open())
+	{
+		return resource;
+	}
+
 	std::streamsize size = file.tellg();
 
 	file.seekg(0, std::ios::beg);
@@ -68,3 +197,77 @@ File Resource::readFilesystem(const std::string& filename)
 	resource.good = true;
 	return resource;
 }
+
+View Resource::view(const std::string& filename)
+{
+	switch (source(filename))
+	{
+	case Source::Resource:
+		return viewResource(filename);
+	case Source::Application:
+		return viewFilesystem("app0:/" + filename);
+	case Source::Filesystem:
+	default:
+		return viewFilesystem(filename);
+	}
+}
+
+View Resource::viewResource(const std::string& filename)
+{
+	return viewOf(ResourceFactory::find(filename));
+}
+
+View Resource::view(ResourceFactory::Name name)
+{
+	return viewOf(ResourceFactory::find(name));
+}
+
+View Resource::viewFilesystem(const std::string& filename)
+{
+	View view;
+	auto file = readFilesystem(filename);
+
+	if (!file.good)
+	{
+		return view;
+	}
+
+	auto storage = std::make_shared<const std::vector<char>>(std::move(file.data));
+	view.data = storage->data();
+	view.size = storage->size();
+	view.good = true;
+	view.storage = std::move(storage);
+	return view;
+}
+
+std::future<File> Resource::readAsync(const std::string& filename)
+{
+	return TaskScheduler::background()->async([filename](void)
+	{
+		return read(filename);
+	});
+}
+
+std::future<View> Resource::viewAsync(const std::string& filename)
+{
+	return TaskScheduler::background()->async([filename](void)
+	{
+		return view(filename);
+	});
+}
+
+std::future<void> Resource::readAsync(const std::string& filename, FileHandler handler)
+{
+	return TaskScheduler::background()->async([filename, handler](void)
+	{
+		handler(read(filename));
+	});
+}
+
+std::future<void> Resource::viewAsync(const std::string& filename, ViewHandler handler)
+{
+	return TaskScheduler::background()->async([filename, handler](void)
+	{
+		handler(view(filename));
+	});
+}
@@ -10,6 +10,11 @@
 #ifndef RESOURCE_H
 #define RESOURCE_H
 
+#include <generatedresources.h>
+
+#include <functional>
+#include <future>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -21,9 +26,43 @@ namespace Resource
 		bool good{false};
 	};
 
+	// a read-only window onto resource data. raw embedded resources are viewed
+	// in place and live for the lifetime of the application. compressed ones
+	// and filesystem files are loaded into storage shared between copies of
+	// the view
+	struct View
+	{
+		const char *data{nullptr};
+		std::size_t size{0};
+		bool good{false};
+		std::shared_ptr<const std::vector<char>> storage;
+
+		bool borrowed(void) const { return good && !storage; }
+	};
+
 	File read(const std::string& filename);
 	File readResource(const std::string& filename);
 	File readFilesystem(const std::string& filename);
+
+	View view(const std::string& filename);
+	View viewResource(const std::string& filename);
+	View viewFilesystem(const std::string& filename);
+
+	// embedded resource by a name hashed at compile time, eg.
+	// Resource::view("rsc:/text.vert.cg.gxp"_rsc)
+	View view(ResourceFactory::Name name);
+
+	// load on the background scheduler so independent loads overlap. the
+	// handler overloads run on the worker, which lets a decode or other
+	// processing of the data happen there too
+	using FileHandler = std::function<void(File)>;
+	using ViewHandler = std::function<void(View)>;
+
+	std::future<File> readAsync(const std::string& filename);
+	std::future<View> viewAsync(const std::string& filename);
+
+	std::future<void> readAsync(const std::string& filename, FileHandler handler);
+	std::future<void> viewAsync(const std::string& filename, ViewHandler handler);
 }
 
 #endif // RESOURCE_H
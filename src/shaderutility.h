@@ -13,25 +13,28 @@
 #include "resource.h"
 #include <easyloggingpp/easylogging++.h>
 
-#include <string>
-
 namespace ShaderUtility
 {
+	// shader programs are always embedded, so they are looked up by id
 	template <typename T>
-	void read(const std::string& file, T* shader)
+	void read(ResourceFactory::Name file, T* shader)
 	{
-		auto fileData = Resource::read(file);
+		auto fileData = Resource::view(file);
 		
 		if (!fileData.good)
 		{
-			LOG(FATAL) << "failed to read resource: \"" << file << "\"";
+			LOG(FATAL) << "failed to read resource: \"" << file.string << "\"";
 		}
 		
-		auto res = shader->loadFromBuffer(fileData.data.data(), fileData.data.size());
+		// raw programs can be used in place, compressed ones are copied
+		// because the view storage goes away once we return
+		auto res = fileData.borrowed()
+			? shader->loadFromStaticBuffer(fileData.data, fileData.size)
+			: shader->loadFromBuffer(fileData.data, fileData.size);
 		
 		if (!res || !shader->valid())
 		{
-			LOG(FATAL) << "failed to load shader program \"" << file << "\"";
+			LOG(FATAL) << "failed to load shader program \"" << file.string << "\"";
 		}
 	}
 }
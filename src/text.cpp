@@ -8,9 +8,8 @@
  */
 
 #include "text.h"
-#include "font.h"
-
-#include <utf8cpp/utf8.h>
+#include "geometryrenderer.h"
+#include "textmeshcache.h"
 
 Text::Text(Font *font, const std::string& text)
 {
@@ -22,118 +21,75 @@ Text::Text(Font *font, const std::string& text)
 void Text::setFont(Font *font)
 {
 	m_font = font;
+	m_dynamicMesh.reset();
 	generateGeometry();
 }
 
-void Text::setText(const std::string& text)
+void Text::setText(std::string_view text)
 {
-	m_text = text;
+	if (m_mesh && text == m_text)
+		return;
+
+	m_text.assign(text.data(), text.size());
+	generateGeometry();
+}
+
+void Text::setDynamic(bool dynamic)
+{
+	if (dynamic == m_dynamic)
+		return;
+
+	m_dynamic = dynamic;
+	m_dynamicMesh.reset();
 	generateGeometry();
 }
 
 float Text::width(void) const
 {
-	return m_boundingBox.x;
+	return boundingBox().x;
 }
 
 float Text::height(void) const
 {
-	return m_boundingBox.y;
+	return boundingBox().y;
 }
 
 glm::vec2 Text::boundingBox(void) const
 {
-	return m_boundingBox;
+	return m_mesh ? m_mesh->boundingBox() : glm::vec2(0.f);
 }
 
 void Text::generateGeometry(void)
 {
 	if (!m_font)
+	{
+		m_mesh.reset();
 		return;
+	}
 
-	utf8::iterator<std::string::const_iterator> it(m_text.begin(), m_text.begin(), m_text.end());
-	utf8::iterator<std::string::const_iterator> end(m_text.end(), m_text.begin(), m_text.end());
-
-	m_vertices = std::make_unique<GpuMemoryBlock<ColouredTextureVertex>>
-	(
-		utf8::distance(m_text.begin(), m_text.end())*4,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_indices = std::make_unique<GpuMemoryBlock<uint16_t>>
-	(
-		utf8::distance(m_text.begin(), m_text.end())*3*2,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	auto vertices = m_vertices->address();
-	auto indices = m_indices->address();
-
-	int x = 0;
-	int y = 0;
-	int heightMax = 0;
-	std::size_t indiceCount = 0;
-	auto prev = 0;
+	if (!m_dynamic)
+	{
+		m_mesh = TextMeshCache::instance()->mesh(m_font, m_text);
+		return;
+	}
 
-	for (auto i = 0; it != end; ++it)
+	if (m_dynamicMesh)
+	{
+		m_dynamicMesh->setText(m_text);
+	}
+	else
 	{
-		auto character = *it;
-		auto glyphInfo = m_font->glyphInfo(character);
-
-		if (prev)
-		{
-			auto kerning = m_font->kerningInfo(character, prev);
-			x += kerning.x;
-		}
-
-		prev = character;
-
-		// bottom left
-		vertices[i+0].position.x = x + glyphInfo.bitmap_left;
-		vertices[i+0].position.y = y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
-		vertices[i+0].position.z = 0;
-		vertices[i+0].texCoord = glyphInfo.quad.bl;
-
-		// bottom right
-		vertices[i+1].position.x = x+glyphInfo.quad.size.x + glyphInfo.bitmap_left;
-		vertices[i+1].position.y = y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
-		vertices[i+1].position.z = 0;
-		vertices[i+1].texCoord = glyphInfo.quad.br;
-
-		// top left
-		vertices[i+2].position.x = x + glyphInfo.bitmap_left;
-		vertices[i+2].position.y = y+glyphInfo.quad.size.y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
-		vertices[i+2].position.z = 0;
-		vertices[i+2].texCoord = glyphInfo.quad.tl;
-
-		// top right
-		vertices[i+3].position.x = x+glyphInfo.quad.size.x + glyphInfo.bitmap_left;
-		vertices[i+3].position.y = y+glyphInfo.quad.size.y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
-		vertices[i+3].position.z = 0;
-		vertices[i+3].texCoord = glyphInfo.quad.tr;
-		
-		indices[indiceCount+0] = i+0;
-		indices[indiceCount+1] = i+1;
-		indices[indiceCount+2] = i+2;
-		indices[indiceCount+3] = i+1;
-		indices[indiceCount+4] = i+3;
-		indices[indiceCount+5] = i+2;
-
-		i += 4;
-		indiceCount += 6;
-
-		x += glyphInfo.advance.x;
-
-		if (y+glyphInfo.quad.size.y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top) > heightMax)
-			heightMax = y+glyphInfo.quad.size.y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
+		m_dynamicMesh = std::make_shared<TextMesh>(*m_font, m_text, true);
 	}
 
-	m_boundingBox = glm::vec2(x, y+heightMax);
+	m_mesh = m_dynamicMesh;
 }
 
 void Text::doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const
 {
-	m_font->atlas()->bind(ctx, 0);
-	sceGxmSetVertexStream(ctx, 0, m_vertices->address());
-	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, m_indices->address(), m_indices->count());
+	if (!m_mesh)
+		return;
+
+	renderer->setColour(m_colour);
+	m_mesh->draw(ctx);
 }
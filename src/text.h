@@ -11,16 +11,16 @@
 #define TEXT_H
 
 #include "geometry.h"
-#include "vertextypes.h"
 
-#include <framework/gpumemoryblock.h>
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 class Font;
+class TextMesh;
 
 class Text : public Geometry
 {
@@ -29,7 +29,14 @@ public:
 	Text(Font *font, const std::string& text);
 
 	void setFont(Font *font);
-	void setText(const std::string& text);
+	// copied in to the string the text already has, so a literal or a
+	// formatted buffer that fits allocates nothing
+	void setText(std::string_view text);
+
+	// text that changes often, such as a counter, keeps a mesh of its own
+	// and lays out each change into the same buffers rather than asking the
+	// cache for a new shared mesh every time
+	void setDynamic(bool dynamic);
 
 	float width(void) const;
 	float height(void) const;
@@ -38,13 +45,7 @@ public:
 
 	void setColour(glm::vec4 colour)
 	{
-		auto vertices = m_vertices->address();
-
-		// apply colour to all vertices
-		for (auto i = 0u; i < m_vertices->count(); ++i)
-		{
-			vertices[i].colour = colour;
-		}
+		m_colour = colour;
 	}
 
 private:
@@ -54,9 +55,12 @@ private:
 private:
 	Font *m_font{nullptr};
 	std::string m_text;
-	glm::vec2 m_boundingBox;
-	std::unique_ptr<GpuMemoryBlock<ColouredTextureVertex>> m_vertices;
-	std::unique_ptr<GpuMemoryBlock<uint16_t>> m_indices;
+	glm::vec4 m_colour{1.f};
+	bool m_dynamic{false};
+
+	// labels showing the same string in the same font share one mesh
+	std::shared_ptr<const TextMesh> m_mesh;
+	std::shared_ptr<TextMesh> m_dynamicMesh;
 };
 
 #endif // TEXT_H
@@ -0,0 +1,349 @@
+/*
+ * textmeshcache.cpp - shared layouts of repeated strings
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "textmeshcache.h"
+#include "fontcache.h"
+
+#include <framework/framering.h>
+#include <framework/quadindexbuffer.h>
+#include <utf8cpp/utf8.h>
+
+#include <psp2/gxm.h>
+
+#include <algorithm>
+
+TextMesh::TextMesh(const Font& font, const std::string& text, bool dynamic)
+	: m_font(font)
+	, m_dynamic(dynamic)
+{
+	// rasterise every missing glyph together rather than one at a time
+	// as the layout reaches them
+	m_font.preload(text);
+	layout(text);
+}
+
+glm::vec2 TextMesh::boundingBox(void) const
+{
+	return m_boundingBox;
+}
+
+void TextMesh::setText(const std::string& text)
+{
+	m_font.preload(text);
+	layout(text);
+}
+
+std::size_t TextMesh::capacity(void) const
+{
+	return m_capacity;
+}
+
+void TextMesh::layout(const std::string& text)
+{
+	auto atlas = m_font.atlas();
+
+	m_characters.clear();
+	m_pages.clear();
+	m_missing = false;
+
+	Pen pen{0.f, 0.f, 0.f, 0};
+
+	// decode, place and write each glyph as we go
+	for (auto it = text.begin(); it != text.end();)
+	{
+		auto character = utf8::next(it, text.end());
+		auto i = m_characters.size();
+
+		reserve(i+1);
+		m_characters.push_back(character);
+		place(i, pen);
+	}
+
+	m_boundingBox = glm::vec2(pen.x, pen.y+pen.heightMax);
+	m_generation = atlas ? atlas->generation() : 0;
+	updateRanges();
+}
+
+void TextMesh::place(std::size_t i, Pen& pen) const
+{
+	auto character = m_characters[i];
+	auto glyphInfo = m_font.glyphInfo(character);
+	auto vertices = &m_glyphs[i*4];
+
+	if (pen.prev)
+	{
+		auto kerning = m_font.kerningInfo(character, pen.prev);
+		pen.x += kerning.x;
+	}
+
+	pen.prev = character;
+
+	auto left = pen.x + glyphInfo.bitmap_left;
+	auto right = pen.x+glyphInfo.quad.size.x + glyphInfo.bitmap_left;
+	auto bottom = pen.y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
+	auto top = pen.y+glyphInfo.quad.size.y-(glyphInfo.quad.size.y - glyphInfo.bitmap_top);
+
+	// bottom left
+	vertices[0].position = glm::vec2(left, bottom);
+	vertices[0].texCoord = glyphInfo.quad.bl;
+
+	// bottom right
+	vertices[1].position = glm::vec2(right, bottom);
+	vertices[1].texCoord = glyphInfo.quad.br;
+
+	// top left
+	vertices[2].position = glm::vec2(left, top);
+	vertices[2].texCoord = glyphInfo.quad.tl;
+
+	// top right
+	vertices[3].position = glm::vec2(right, top);
+	vertices[3].texCoord = glyphInfo.quad.tr;
+
+	m_pages.push_back({glyphInfo.page, i});
+	m_missing |= missing(character, glyphInfo);
+
+	pen.x += glyphInfo.advance.x;
+
+	if (top > pen.heightMax)
+		pen.heightMax = top;
+}
+
+bool TextMesh::missing(unsigned int character, const Font::GlyphInfo& glyphInfo) const
+{
+	// a full atlas leaves glyphs out until it has made room between frames.
+	// only glyphs without a region can be one of those
+	if (glyphInfo.quad.size.x)
+		return false;
+
+	auto atlas = m_font.atlas();
+	return atlas && !atlas->contains(character);
+}
+
+void TextMesh::reserve(std::size_t characters)
+{
+	if (characters <= m_capacity)
+		return;
+
+	// grow geometrically so text that keeps changing length settles on one
+	// buffer
+	m_capacity = std::max(characters, m_capacity*2);
+	m_glyphs.resize(m_capacity*4);
+}
+
+void TextMesh::updateGlyphs(void) const
+{
+	auto atlas = m_font.atlas();
+
+	if (!atlas)
+		return;
+
+	m_generation = atlas->generation();
+	m_pages.clear();
+
+	// the glyphs left out of a layout had no metrics either, so the whole
+	// text is placed again now there may be room for them
+	if (m_missing)
+	{
+		Pen pen{0.f, 0.f, 0.f, 0};
+		m_missing = false;
+
+		for (auto i = 0u; i < m_characters.size(); ++i)
+		{
+			place(i, pen);
+		}
+
+		m_boundingBox = glm::vec2(pen.x, pen.y+pen.heightMax);
+		updateRanges();
+		return;
+	}
+
+	for (auto i = 0u; i < m_characters.size(); ++i)
+	{
+		// glyphs evicted since the geometry was built are rendered again
+		auto glyphInfo = m_font.glyphInfo(m_characters[i]);
+
+		m_glyphs[i*4+0].texCoord = glyphInfo.quad.bl;
+		m_glyphs[i*4+1].texCoord = glyphInfo.quad.br;
+		m_glyphs[i*4+2].texCoord = glyphInfo.quad.tl;
+		m_glyphs[i*4+3].texCoord = glyphInfo.quad.tr;
+		m_pages.push_back({glyphInfo.page, i});
+		m_missing |= missing(m_characters[i], glyphInfo);
+	}
+
+	updateRanges();
+}
+
+void TextMesh::updateRanges(void) const
+{
+	// each glyph appears once, so this keeps string order within a page
+	// without the buffer a stable sort would allocate
+	std::sort(m_pages.begin(), m_pages.end());
+	m_ranges.clear();
+
+	for (auto i = 0u; i < m_pages.size(); ++i)
+	{
+		if (m_ranges.empty() || m_ranges.back().page != m_pages[i].first)
+		{
+			m_ranges.push_back({m_pages[i].first, i, 0});
+		}
+
+		++m_ranges.back().count;
+	}
+
+	if (m_dynamic || m_pages.empty())
+		return;
+
+	// the gpu may still be drawing earlier frames from the vertices we have,
+	// so a new layout goes in to a buffer of its own
+	auto vertices = std::make_unique<GpuHeapBlock<TextVertex>>(m_pages.size()*4);
+	writeVertices(vertices->address());
+
+	if (m_vertices)
+	{
+		FrameRing::instance()->release(std::move(m_vertices));
+	}
+
+	m_vertices = std::move(vertices);
+}
+
+void TextMesh::writeVertices(TextVertex *vertices) const
+{
+	for (auto& glyph : m_pages)
+	{
+		std::copy_n(&m_glyphs[glyph.second*4], 4, vertices);
+		vertices += 4;
+	}
+}
+
+void TextMesh::draw(SceGxmContext *ctx) const
+{
+	auto atlas = m_font.atlas();
+
+	if (!atlas || m_characters.empty())
+		return;
+
+	// keep our glyphs from being evicted while we are on screen. a mesh
+	// shown by several labels is only refreshed by the first to draw it
+	if (atlas->generation() != m_generation)
+	{
+		updateGlyphs();
+	}
+	else
+	{
+		for (auto character : m_characters)
+		{
+			atlas->touch(character);
+		}
+	}
+
+	auto vertices = m_vertices ? m_vertices->address() : nullptr;
+
+	// the text may change again before the gpu is done with this frame, so
+	// draw from a copy of our own
+	if (m_dynamic)
+	{
+		vertices = FrameRing::instance()->allocate<TextVertex>(m_characters.size()*4);
+		writeVertices(vertices);
+	}
+
+	auto quads = QuadIndexBuffer::instance();
+	sceGxmSetVertexStream(ctx, 0, vertices);
+
+	for (auto& range : m_ranges)
+	{
+		atlas->bind(ctx, 0, range.page);
+		quads->draw(ctx, range.first, range.count);
+	}
+}
+
+TextMeshCache *TextMeshCache::instance(void)
+{
+	static TextMeshCache cache;
+	return &cache;
+}
+
+TextMeshCache::MeshPtr TextMeshCache::mesh(const Font *font, const std::string& text)
+{
+	auto store = font->store();
+
+	if (!store)
+		return nullptr;
+
+	Key key(store, font->m_pointSize, text);
+
+	if (auto mesh = find(key))
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_statistics.hits;
+		return mesh;
+	}
+
+	auto mesh = std::make_unique<TextMesh>(*font, text);
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_statistics.misses;
+	}
+
+	// another thread may have laid out the same string meanwhile
+	if (auto existing = find(key))
+		return existing;
+
+	return insert(key, std::move(mesh));
+}
+
+TextMeshCache::Statistics TextMeshCache::statistics(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statistics;
+}
+
+TextMeshCache::MeshPtr TextMeshCache::find(const Key& key)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_meshes.find(key);
+
+	if (it == m_meshes.end())
+		return nullptr;
+
+	return it->second.lock();
+}
+
+TextMeshCache::MeshPtr TextMeshCache::insert(const Key& key, std::unique_ptr<TextMesh> mesh)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	MeshPtr ptr(mesh.release(), [this, key](const TextMesh *mesh)
+	{
+		this->release(key, mesh);
+	});
+
+	++m_statistics.meshesResident;
+	m_meshes[key] = ptr;
+	return ptr;
+}
+
+void TextMeshCache::release(const Key& key, const TextMesh *mesh)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		--m_statistics.meshesResident;
+
+		auto it = m_meshes.find(key);
+
+		// the string may have been laid out again since the last label went
+		// away
+		if (it != m_meshes.end() && it->second.expired())
+		{
+			m_meshes.erase(it);
+		}
+	}
+
+	delete mesh;
+}
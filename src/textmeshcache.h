@@ -0,0 +1,147 @@
+/*
+ * textmeshcache.h - shared layouts of repeated strings
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef TEXTMESHCACHE_H
+#define TEXTMESHCACHE_H
+
+#include "font.h"
+#include "vertextypes.h"
+
+#include <framework/gpuheap.h>
+#include <glm/vec2.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct SceGxmContext;
+
+class GlyphStore;
+
+// the laid out glyphs of a string in one font and size. a mesh carries no
+// colour or transform, so every label showing the same string draws the
+// same one
+class TextMesh
+{
+public:
+	// a dynamic mesh copies its glyphs to the frame ring each draw rather
+	// than keeping them in gpu memory, so its text can change while on screen
+	TextMesh(const Font& font, const std::string& text, bool dynamic = false);
+
+	TextMesh(const TextMesh&) = delete;
+	TextMesh& operator=(const TextMesh&) = delete;
+
+	glm::vec2 boundingBox(void) const;
+
+	// lay out other text into the same buffers, which only grow when it
+	// does not fit. only for dynamic meshes
+	void setText(const std::string& text);
+	std::size_t capacity(void) const;
+
+	// the caller binds the program and sets the colour and mvp
+	void draw(SceGxmContext *ctx) const;
+
+private:
+	// glyphs on the same atlas page are next to each other in the vertex
+	// stream and drawn together, counted in quads
+	struct DrawRange
+	{
+		unsigned int page;
+		std::size_t first;
+		std::size_t count;
+	};
+
+private:
+	// where the next glyph goes. distance field fonts have fractional
+	// metrics once scaled
+	struct Pen
+	{
+		float x;
+		float y;
+		float heightMax;
+		unsigned int prev;
+	};
+
+private:
+	void layout(const std::string& text);
+	void place(std::size_t i, Pen& pen) const;
+	bool missing(unsigned int character, const Font::GlyphInfo& glyphInfo) const;
+	void reserve(std::size_t characters);
+	void updateGlyphs(void) const;
+	void updateRanges(void) const;
+	void writeVertices(TextVertex *vertices) const;
+
+private:
+	// our own handle keeps the glyph store alive as long as the mesh
+	mutable Font m_font;
+	mutable glm::vec2 m_boundingBox;
+	std::vector<unsigned int> m_characters;
+	std::size_t m_capacity{0};
+	bool m_dynamic;
+
+	// four vertices a glyph in string order, and the vertex stream drawn
+	// from in page order. a dynamic mesh writes the stream each draw
+	mutable std::vector<TextVertex> m_glyphs;
+	mutable std::unique_ptr<GpuHeapBlock<TextVertex>> m_vertices;
+
+	// the atlas can move glyphs between frames, the texture coordinates and
+	// draw ranges are refreshed whenever its generation changes
+	mutable std::vector<DrawRange> m_ranges;
+	mutable std::vector<std::pair<unsigned int, std::size_t>> m_pages;
+	mutable unsigned int m_generation{0};
+
+	// a glyph was left out of the layout as the atlas had no room for it
+	mutable bool m_missing{false};
+};
+
+// lays out each string once per glyph store and point size. like the
+// texture cache it only holds weak references, so a mesh is released with
+// the last label showing it
+class TextMeshCache
+{
+public:
+	using MeshPtr = std::shared_ptr<const TextMesh>;
+
+	struct Statistics
+	{
+		unsigned int hits;
+		unsigned int misses;
+		std::size_t meshesResident;
+	};
+
+public:
+	static TextMeshCache *instance(void);
+
+	MeshPtr mesh(const Font *font, const std::string& text);
+
+	Statistics statistics(void) const;
+
+private:
+	// distance field fonts of every size share a store, so the size is part
+	// of the key as well
+	using Key = std::tuple<const GlyphStore *, float, std::string>;
+
+private:
+	TextMeshCache(void) = default;
+
+	MeshPtr find(const Key& key);
+	MeshPtr insert(const Key& key, std::unique_ptr<TextMesh> mesh);
+	void release(const Key& key, const TextMesh *mesh);
+
+private:
+	mutable std::mutex m_mutex;
+	std::map<Key, std::weak_ptr<const TextMesh>> m_meshes;
+	Statistics m_statistics{0, 0, 0};
+};
+
+#endif // TEXTMESHCACHE_H
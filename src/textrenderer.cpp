@@ -11,6 +11,8 @@
 #include "shaderutility.h"
 #include "font.h"
 
+#include <framework/quadindexbuffer.h>
+
 #include <string>
 
 #include <utf8cpp/utf8.h>
@@ -19,8 +21,8 @@ TextRenderer::TextRenderer(GxmShaderPatcher *patcher)
 	: m_program(patcher)
 {
 	// read shaders
-	ShaderUtility::read("rsc:/text.vert.cg.gxp", &m_vertexShader);
-	ShaderUtility::read("rsc:/text.frag.cg.gxp", &m_fragmentShader);
+	ShaderUtility::read("rsc:/text.vert.cg.gxp"_rsc, &m_vertexShader);
+	ShaderUtility::read("rsc:/text.frag.cg.gxp"_rsc, &m_fragmentShader);
 
 	// add programs
 	m_program.addShader(&m_vertexShader);
@@ -28,32 +30,11 @@ TextRenderer::TextRenderer(GxmShaderPatcher *patcher)
 
 	m_mvpIndex = m_vertexShader.uniformIndex("mvp");
 	
-	SceGxmVertexAttribute attributes[3];
-	SceGxmVertexStream streams[3];
-
-	attributes[0].streamIndex = 0;
-	attributes[0].offset = 0;
-	attributes[0].format = SCE_GXM_ATTRIBUTE_FORMAT_F32;
-	attributes[0].componentCount = 3;
-	attributes[0].regIndex = sceGxmProgramParameterGetResourceIndex(m_vertexShader.attributeIndex("position"));
-
-	attributes[1].streamIndex = 0;
-	attributes[1].offset = sizeof(float)*3;
-	attributes[1].format = SCE_GXM_ATTRIBUTE_FORMAT_F32;
-	attributes[1].componentCount = 2;
-	attributes[1].regIndex = sceGxmProgramParameterGetResourceIndex(m_vertexShader.attributeIndex("texCoord"));
-
-	attributes[2].streamIndex = 0;
-	attributes[2].offset = 0;
-	attributes[2].format = SCE_GXM_ATTRIBUTE_FORMAT_F32;
-	attributes[2].componentCount = 3;
-	attributes[2].regIndex = sceGxmProgramParameterGetResourceIndex(m_vertexShader.attributeIndex("position"));
+	auto attributes = TextVertex::attributes(&m_vertexShader);
+	auto streams = TextVertex::streams();
 
-	streams[0].stride = sizeof(TextGeometry::TextVertex);
-	streams[0].indexSource = SCE_GXM_INDEX_SOURCE_INDEX_16BIT;
-
-	m_program.setVertexAttributeFormat(attributes, 2);
-	m_program.setVertexStreamFormat(streams, 1);
+	m_program.setVertexAttributeFormat(attributes.data(), attributes.size());
+	m_program.setVertexStreamFormat(streams.data(), streams.size());
 
 	SceGxmBlendInfo blendInfo;
 	blendInfo.colorFunc = SCE_GXM_BLEND_FUNC_ADD;
@@ -78,56 +59,33 @@ TextGeometry *TextRenderer::generateTextGeometry(const std::string& text)
 	utf8::iterator<std::string::const_iterator> end(text.end(), text.begin(), text.end());
 	TextGeometry *geometry = new TextGeometry;
 
-	std::vector<TextGeometry::TextVertex> vertices(utf8::distance(text.begin(), text.end())*4);
-	std::vector<std::uint16_t> indices(utf8::distance(text.begin(), text.end())*3*2);
+	std::vector<TextVertex> vertices(utf8::distance(text.begin(), text.end())*4);
 
 	int x = 0;
 	int y = 0;
-	std::size_t indiceCount = 0;
 
 	for (auto i = 0; it != end; ++it)
 	{
 		auto glyphInfo = m_font->glyphInfo(*it);
 
-		vertices[i+0].x = x;
-		vertices[i+0].y = y;
-		vertices[i+0].z = 0;
-		vertices[i+0].u = glyphInfo.quad.bl.x;
-		vertices[i+0].v = glyphInfo.quad.bl.y;
-
-		vertices[i+1].x = x+glyphInfo.quad.size.x;
-		vertices[i+1].y = y;
-		vertices[i+1].z = 0;
-		vertices[i+1].u = glyphInfo.quad.br.x;
-		vertices[i+1].v = glyphInfo.quad.br.y;
-
-		vertices[i+2].x = x;
-		vertices[i+2].y = y+glyphInfo.quad.size.y;
-		vertices[i+2].z = 0;
-		vertices[i+2].u = glyphInfo.quad.tl.x;
-		vertices[i+2].v = glyphInfo.quad.tl.y;
-
-		vertices[i+3].x = x+glyphInfo.quad.size.x;
-		vertices[i+3].y = y+glyphInfo.quad.size.y;
-		vertices[i+3].z = 0;
-		vertices[i+3].u = glyphInfo.quad.tr.x;
-		vertices[i+3].v = glyphInfo.quad.tr.y;
-
-		indices[indiceCount+0] = i+0;
-		indices[indiceCount+1] = i+1;
-		indices[indiceCount+2] = i+2;
-		indices[indiceCount+3] = i+1;
-		indices[indiceCount+4] = i+3;
-		indices[indiceCount+5] = i+2;
+		vertices[i+0].position = glm::vec2(x, y);
+		vertices[i+0].texCoord = glyphInfo.quad.bl;
+
+		vertices[i+1].position = glm::vec2(x+glyphInfo.quad.size.x, y);
+		vertices[i+1].texCoord = glyphInfo.quad.br;
+
+		vertices[i+2].position = glm::vec2(x, y+glyphInfo.quad.size.y);
+		vertices[i+2].texCoord = glyphInfo.quad.tl;
+
+		vertices[i+3].position = glm::vec2(x+glyphInfo.quad.size.x, y+glyphInfo.quad.size.y);
+		vertices[i+3].texCoord = glyphInfo.quad.tr;
 
 		i += 4;
-		indiceCount += 6;
 
 		x += glyphInfo.advance.x;
 	}
 
 	geometry->setVertices(std::move(vertices));
-	geometry->setIndices(std::move(indices));
 	return geometry;
 }
 
@@ -147,5 +105,5 @@ void TextRenderer::draw(SceGxmContext *ctx, TextGeometry *geometry)
 	m_vertexShader.setUniformValue(m_mvpIndex, m_mvp);
 
 	sceGxmSetVertexStream(ctx, 0, geometry->vertices()->address());
-	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, geometry->indices()->address(), geometry->indices()->count());
+	QuadIndexBuffer::instance()->draw(ctx, 0, geometry->vertices()->count()/4);
 }
@@ -10,6 +10,8 @@
 #ifndef TEXTRENDERER_H
 #define TEXTRENDERER_H
 
+#include "vertextypes.h"
+
 #include <framework/gpumemoryblock.h>
 #include <framework/gxmshaderprogram.h>
 #include <framework/gxmvertexshader.h>
@@ -22,13 +24,6 @@
 
 class TextGeometry
 {
-public:
-	struct TextVertex
-	{
-		float x, y, z;
-		float u, v;
-	};
-
 public:
 	void setVertices(std::vector<TextVertex>&& vertices)
 	{
@@ -41,30 +36,13 @@ public:
 		std::memcpy(m_vertices->address(), vertices.data(), vertices.size()*sizeof(TextVertex));
 	}
 
-	void setIndices(std::vector<uint16_t>&& indices)
-	{
-		m_indices = std::make_unique<GpuMemoryBlock<uint16_t>>
-		(
-			indices.size(),
-			SCE_GXM_MEMORY_ATTRIB_READ
-		);
-
-		std::memcpy(m_indices->address(), indices.data(), indices.size()*sizeof(uint16_t));
-	}
-
 	GpuMemoryBlock<TextVertex> *vertices(void) const
 	{
 		return m_vertices.get();
 	}
 
-	GpuMemoryBlock<uint16_t> *indices(void) const
-	{
-		return m_indices.get();
-	}
-
 private:
 	std::unique_ptr<GpuMemoryBlock<TextVertex>> m_vertices;
-	std::unique_ptr<GpuMemoryBlock<uint16_t>> m_indices;
 };
 
 class Font;
@@ -41,9 +41,19 @@
 
 #include "textureatlas.h"
 
+#include <algorithm>
 #include <limits>
+#include <numeric>
 #include <cstring>
 
+namespace
+{
+	// dirty rectangles are merged, and widened to whole rows, as long as that
+	// copies at most this many times the pixels they cover. fewer, larger
+	// copies are cheaper than a copy per glyph row
+	constexpr int MERGE_OVERHEAD = 2;
+}
+
 TextureAtlas::TextureAtlas(void)
 {
 	
@@ -69,6 +79,7 @@ void TextureAtlas::create(GxmTexture::Filter minFilter, GxmTexture::Filter magFi
 	allocateStorage();
 	setEmptyData();
 	setMinMagFilter(minFilter, magFilter);
+	m_staging.assign(storageSize(), 0);
 	m_nodes.push_back(glm::ivec3(1, 1, width()-2));
 }
 
@@ -81,7 +92,25 @@ void TextureAtlas::setRegion(AtlasRegion region, const char *data, std::size_t s
 	
 	for (auto i = 0; i < height; ++i)
 	{
-		std::memcpy(storage() + ((y+i)*this->width() + x), data + (i*stride), width);
+		std::memcpy(m_staging.data() + ((y+i)*this->width() + x), data + (i*stride), width);
+	}
+
+	if (width > 0 && height > 0)
+	{
+		m_dirty.push_back(glm::ivec4(x, y, width, height));
+	}
+}
+
+void TextureAtlas::regionData(AtlasRegion region, char *data, std::size_t stride) const
+{
+	auto x = region.x;
+	auto y = region.y;
+	auto width = region.z-1;
+	auto height = region.w-1;
+
+	for (auto i = 0; i < height; ++i)
+	{
+		std::memcpy(data + (i*stride), m_staging.data() + ((y+i)*this->width() + x), width);
 	}
 }
 
@@ -96,29 +125,31 @@ TextureAtlas::AtlasRegion TextureAtlas::region(std::size_t width, std::size_t he
 	height += 1;
 
 	auto region = AtlasRegion(0, 0, width, height);
-	auto best_node = m_nodes.end();
-	
-	for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it)
+	auto best = m_nodes.size();
+
+	for (auto i = 0u; i < m_nodes.size(); ++i)
 	{
-		auto y = fit(it, width, height);
-		
+		// a fit reaching further down than the best so far is given up on as
+		// soon as it does
+		auto y = fit(i, width, height, std::min(best_height, this->height()-1));
+
 		if (y >= 0)
 		{
-			auto node = *it;
-			
+			auto& node = m_nodes[i];
+
 			if (((y + height) < best_height)
 				|| (((y + height) == best_height) && (node.z > 0 && static_cast<std::size_t>(node.z) < best_width)))
 			{
 				best_height = y + height;
 				best_width = node.z;
-				best_node = it;
+				best = i;
 				region.x = node.x;
 				region.y = y;
 			}
 		}
 	}
 
-	if (best_node == m_nodes.end())
+	if (best == m_nodes.size())
 	{
 		region.x = -1;
 		region.y = -1;
@@ -127,37 +158,143 @@ TextureAtlas::AtlasRegion TextureAtlas::region(std::size_t width, std::size_t he
 		return region;
 	}
 
-	m_nodes.insert(best_node, glm::ivec3(region.x, region.y + height, width));
-	for (auto it = best_node; it != m_nodes.end();)
+	m_nodes.insert(m_nodes.begin() + best, glm::ivec3(region.x, region.y + height, width));
+
+	// the nodes the region now covers go, and the one it overlaps shrinks
+	auto right = region.x + region.z;
+	auto end = best + 1;
+
+	while (end < m_nodes.size() && m_nodes[end].x + m_nodes[end].z <= right)
+		++end;
+
+	if (end < m_nodes.size() && m_nodes[end].x < right)
+	{
+		m_nodes[end].z -= right - m_nodes[end].x;
+		m_nodes[end].x = right;
+	}
+
+	m_nodes.erase(m_nodes.begin() + best + 1, m_nodes.begin() + end);
+
+	merge(best);
+	return region;
+}
+
+std::vector<TextureAtlas::AtlasRegion> TextureAtlas::regionBatch(const std::vector<glm::uvec2>& sizes)
+{
+	std::vector<std::size_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0);
+
+	std::stable_sort(order.begin(), order.end(), [&sizes](std::size_t a, std::size_t b)
+	{
+		if (sizes[a].y != sizes[b].y)
+			return sizes[a].y > sizes[b].y;
+
+		return sizes[a].x > sizes[b].x;
+	});
+
+	std::vector<AtlasRegion> regions(sizes.size());
+
+	for (auto i : order)
+	{
+		regions[i] = region(sizes[i].x, sizes[i].y);
+	}
+
+	return regions;
+}
+
+void TextureAtlas::reserve(std::size_t height)
+{
+	// everything above height is already in use, new regions go below it
+	m_nodes.clear();
+	m_nodes.push_back(glm::ivec3(1, height, width()-2));
+}
+
+void TextureAtlas::clear(void)
+{
+	// regions rely on their border being empty, so the pixels go too. the
+	// texture is written by the next flush since reinitialising it would
+	// also reset its filtering
+	std::fill(m_staging.begin(), m_staging.end(), 0);
+	m_dirty.assign(1, glm::ivec4(0, 0, width(), height()));
+	m_nodes.clear();
+	m_nodes.push_back(glm::ivec3(1, 1, width()-2));
+}
+
+void TextureAtlas::bind(SceGxmContext *ctx, std::uint32_t unit)
+{
+	flush();
+	GxmTexture::bind(ctx, unit);
+}
+
+std::size_t TextureAtlas::flush(void)
+{
+	if (m_dirty.empty())
+		return 0;
+
+	std::sort(m_dirty.begin(), m_dirty.end(), [](const glm::ivec4& a, const glm::ivec4& b)
 	{
-		auto node = it;
-		auto prev = std::prev(it);
-		
-		if (node->x < (prev->x + prev->z))
+		return a.y < b.y;
+	});
+
+	std::vector<glm::ivec4> merged;
+	std::vector<int> mergedArea;
+
+	for (auto& rect : m_dirty)
+	{
+		if (!merged.empty() && rect.y <= merged.back().y + merged.back().w)
 		{
-			int shrink = prev->x + prev->z - node->x;
-			node->x += shrink;
-			node->z -= shrink;
-			
-			if (node->z <= 0)
-			{
-				it = m_nodes.erase(it);
-			}
-			else
+			auto& last = merged.back();
+			auto left = std::min(last.x, rect.x);
+			auto right = std::max(last.x + last.z, rect.x + rect.z);
+			auto bottom = std::max(last.y + last.w, rect.y + rect.w);
+			auto area = mergedArea.back() + rect.z*rect.w;
+
+			if ((right - left)*(bottom - last.y) <= area*MERGE_OVERHEAD)
 			{
-				++it;
-				break;
+				last.x = left;
+				last.z = right - left;
+				last.w = bottom - last.y;
+				mergedArea.back() = area;
+				continue;
 			}
 		}
-		else
+
+		merged.push_back(rect);
+		mergedArea.push_back(rect.z*rect.w);
+	}
+
+	std::size_t bytes = 0;
+
+	for (auto& rect : merged)
+	{
+		if (static_cast<std::size_t>(rect.z*MERGE_OVERHEAD) >= width())
 		{
-			++it;
-			break;
+			rect.x = 0;
+			rect.z = width();
 		}
+
+		updateRegion(rect.x, rect.y, rect.z, rect.w, m_staging.data() + rect.y*width() + rect.x, width());
+		bytes += rect.z*rect.w;
 	}
-	
-	merge();
-	return region;
+
+	m_dirty.clear();
+	m_uploadedBytes += bytes;
+	return bytes;
+}
+
+std::size_t TextureAtlas::uploadedBytes(void) const
+{
+	return m_uploadedBytes;
+}
+
+const TextureAtlas::Skyline& TextureAtlas::skyline(void) const
+{
+	return m_nodes;
+}
+
+void TextureAtlas::setSkyline(const Skyline& skyline)
+{
+	m_nodes = skyline;
 }
 
 TextureAtlas::Quad TextureAtlas::toQuad(AtlasRegion region)
@@ -180,11 +317,10 @@ TextureAtlas::Quad TextureAtlas::toQuad(AtlasRegion region)
 	return quad;
 }
 
-int TextureAtlas::fit(NodeList::iterator it, std::size_t width, std::size_t height)
+int TextureAtlas::fit(std::size_t index, std::size_t width, std::size_t height, std::size_t bottom) const
 {
-	auto node = *it;
-	auto x = node.x;
-	auto y = node.y;
+	auto x = m_nodes[index].x;
+	auto y = m_nodes[index].y;
 	int width_left = width;
 
 	if ((x + width) > (this->width()-1))
@@ -192,45 +328,38 @@ int TextureAtlas::fit(NodeList::iterator it, std::size_t width, std::size_t heig
 		return -1;
 	}
 
-	while (width_left > 0)
+	// the skyline always spans the texture, so this stays within the nodes
+	for (auto i = index; width_left > 0; ++i)
 	{
-		node = *it;
-		
-		if (node.y > y)
+		if (m_nodes[i].y > y)
 		{
-			y = node.y;
+			y = m_nodes[i].y;
 		}
-		
-		if ((y + height) > this->height()-1)
+
+		if ((y + height) > bottom)
 		{
 			return -1;
 		}
 
-		width_left -= node.z;
-		++it;
+		width_left -= m_nodes[i].z;
 	}
 
 	return y;
 }
 
-void TextureAtlas::merge(void)
+void TextureAtlas::merge(std::size_t index)
 {
-	for (auto it = m_nodes.begin(); it != m_nodes.end();)
+	// the skyline was merged before the insert, so only the new node can
+	// share a height with its neighbours
+	if (index + 1 < m_nodes.size() && m_nodes[index].y == m_nodes[index+1].y)
 	{
-		auto node = it;
-		auto next = std::next(it);
-
-		if (next == m_nodes.end())
-			return;
+		m_nodes[index].z += m_nodes[index+1].z;
+		m_nodes.erase(m_nodes.begin() + index + 1);
+	}
 
-		if (node->y == next->y)
-		{
-			node->z += next->z;
-			m_nodes.erase(next);
-		}
-		else
-		{
-			++it;
-		}
+	if (index > 0 && m_nodes[index-1].y == m_nodes[index].y)
+	{
+		m_nodes[index-1].z += m_nodes[index].z;
+		m_nodes.erase(m_nodes.begin() + index);
 	}
 }
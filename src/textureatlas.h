@@ -6,12 +6,17 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
-#include <list>
+#include <vector>
 
 class TextureAtlas : private GxmTexture
 {
 public:
 	using AtlasRegion = glm::ivec4;
+
+	// the free space of the atlas as runs of x, y and width, spanning every
+	// column from 1 to width-1 left to right
+	using Skyline = std::vector<glm::ivec3>;
+
 	struct Quad
 	{
 		glm::vec2 bl;
@@ -32,22 +37,47 @@ public:
 	using GxmTexture::height;
 
 	using GxmTexture::setFormat;
-	using GxmTexture::bind;
+
+	// anything written since the last upload goes to the texture first
+	void bind(SceGxmContext *ctx, std::uint32_t unit);
 
 	void create(GxmTexture::Filter minFilter, GxmTexture::Filter magFilter);
 
 	AtlasRegion region(std::size_t width, std::size_t height);
+
+	// packs every size at once, tallest first, which fills the skyline far
+	// more tightly than inserting in arrival order. regions are returned in
+	// the order of sizes, with x and y of -1 for any that did not fit
+	std::vector<AtlasRegion> regionBatch(const std::vector<glm::uvec2>& sizes);
+	void reserve(std::size_t height);
+	void clear(void);
+
+	// for saving a page and restoring it later along with its pixels
+	const Skyline& skyline(void) const;
+	void setSkyline(const Skyline& skyline);
+
 	void setRegion(AtlasRegion region, const char *data, std::size_t stride);
+	void regionData(AtlasRegion region, char *data, std::size_t stride) const;
 
 	Quad toQuad(AtlasRegion region);
 
+	// regions are written to a copy of the atlas in cached memory, and only
+	// copied to the texture by flush. neighbouring rectangles are copied
+	// together. returns the bytes copied
+	std::size_t flush(void);
+	std::size_t uploadedBytes(void) const;
+
 private:
-	using NodeList = std::list<glm::ivec3>;
-	int fit(NodeList::iterator it, std::size_t width, std::size_t height);
-	void merge(void);
+	int fit(std::size_t index, std::size_t width, std::size_t height, std::size_t bottom) const;
+	void merge(std::size_t index);
 
 private:
-	NodeList m_nodes;
+	Skyline m_nodes;
+	std::vector<char> m_staging;
+
+	// x, y, width and height of each rectangle written since the last flush
+	std::vector<glm::ivec4> m_dirty;
+	std::size_t m_uploadedBytes{0};
 };
 
 #endif // TEXTUREATLAS_H
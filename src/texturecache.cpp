@@ -0,0 +1,263 @@
+/*
+ * texturecache.cpp - share decoded textures between their users
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "texturecache.h"
+#include "resource.h"
+
+#include <framework/taskscheduler.h>
+
+#include <png++/png.hpp>
+
+#include <cstring>
+
+#include <easyloggingpp/easylogging++.h>
+
+namespace
+{
+	class ViewStream : public std::basic_streambuf<char, std::char_traits<char>>
+	{
+	public:
+		ViewStream(const Resource::View& v)
+		{
+			// the stream is only ever read from
+			auto data = const_cast<char *>(v.data);
+			setg(data, data, data+v.size);
+		}
+	};
+
+	// written by tools/texturebake.py
+	struct BakedTextureHeader
+	{
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t format;
+		std::uint32_t width;
+		std::uint32_t height;
+		std::uint32_t stride;
+		std::uint32_t flags;
+		std::uint32_t dataOffset;
+	};
+
+	constexpr std::uint32_t BAKED_TEXTURE_VERSION = 1;
+	constexpr std::uint32_t BAKED_TEXTURE_SWIZZLED = 1;
+
+	bool isBakedTexture(const Resource::View& view)
+	{
+		return view.size >= sizeof(BakedTextureHeader) && std::memcmp(view.data, "RTEX", 4) == 0;
+	}
+
+	std::unique_ptr<GxmTexture> loadBakedTexture(const std::string& file, const Resource::View& view)
+	{
+		BakedTextureHeader header;
+		std::memcpy(&header, view.data, sizeof(header));
+
+		if (header.version != BAKED_TEXTURE_VERSION || header.format > GxmTexture::UBC3)
+		{
+			LOG(FATAL) << "unsupported baked texture: " << file;
+		}
+
+		auto texture = std::make_unique<GxmTexture>();
+		texture->setSize(header.width, header.height);
+		texture->setFormat(static_cast<GxmTexture::TextureFormat>(header.format));
+
+		if (header.flags & BAKED_TEXTURE_SWIZZLED)
+		{
+			texture->setLayout(GxmTexture::Layout::Swizzled);
+		}
+
+		if (header.stride != texture->stride() || header.dataOffset + texture->storageSize() > view.size)
+		{
+			LOG(FATAL) << "corrupt baked texture: " << file;
+		}
+
+		// already in the layout the gpu samples, so this is a single copy
+		texture->allocateStorage();
+		texture->setData(view.data + header.dataOffset);
+		return texture;
+	}
+
+	std::unique_ptr<GxmTexture> decodePngTexture(const Resource::View& view)
+	{
+		ViewStream vstream(view);
+		std::istream stream(&vstream);
+
+		png::reader<std::istream> reader(stream);
+		reader.read_info();
+
+		// have libpng expand palette, grey and 16 bit images to 8 bit rgba
+		// as part of decoding, so each row is already in its final layout
+		png::convert_color_space<png::rgba_pixel>()(reader);
+		auto passes = reader.set_interlace_handling();
+		reader.update_info();
+
+		auto texture = std::make_unique<GxmTexture>();
+		texture->setSize(reader.get_width(), reader.get_height());
+		texture->setFormat(GxmTexture::ARGB8);
+		texture->allocateStorage();
+
+		// rows are decoded straight into gpu storage, there is no
+		// intermediate copy of the image. interlaced images revisit every
+		// row once per pass, which reads back from uncached memory but
+		// none of our assets are interlaced
+		texture->writeData([&reader, passes, texture = texture.get()](char *data, std::size_t stride)
+		{
+			for (auto pass = 0; pass < passes; ++pass)
+			{
+				for (auto y = 0u; y < texture->height(); ++y)
+				{
+					reader.read_row(reinterpret_cast<png::byte *>(data + y*stride));
+				}
+			}
+		});
+
+		reader.read_end_info();
+		return texture;
+	}
+
+	std::future<std::unique_ptr<GxmTexture>> decodeTexture(const std::string& file)
+	{
+		return TaskScheduler::background()->async([file](void)
+		{
+			auto fileData = Resource::view(file);
+
+			if (!fileData.good)
+			{
+				LOG(FATAL) << "could not load texture: " << file;
+			}
+
+			// textures baked at build time skip png decoding entirely
+			auto texture = isBakedTexture(fileData) ? loadBakedTexture(file, fileData) : decodePngTexture(fileData);
+			texture->setMinMagFilter(GxmTexture::Linear, GxmTexture::Linear);
+			texture->setWrapMode(GxmTexture::Repeat);
+			return texture;
+		});
+	}
+} // anonymous namespace
+
+TextureCache *TextureCache::instance(void)
+{
+	static TextureCache cache;
+	return &cache;
+}
+
+TextureCache::TexturePtr TextureCache::texture(const std::string& file)
+{
+	return textures({ file }).front();
+}
+
+std::vector<TextureCache::TexturePtr> TextureCache::textures(const std::vector<std::string>& files)
+{
+	std::vector<TexturePtr> textures(files.size());
+	std::vector<std::pair<std::size_t, std::future<std::unique_ptr<GxmTexture>>>> pending;
+
+	// a path that appears more than once in the batch is decoded once, the
+	// later indices share the first one's texture
+	std::unordered_map<std::string, std::size_t> decoding;
+	std::vector<std::pair<std::size_t, std::size_t>> duplicates;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (auto i = 0u; i < files.size(); ++i)
+		{
+			auto it = m_textures.find(files[i]);
+
+			if (it != m_textures.end())
+			{
+				textures[i] = it->second.lock();
+			}
+
+			if (textures[i])
+			{
+				++m_statistics.hits;
+				continue;
+			}
+
+			auto first = decoding.emplace(files[i], i);
+
+			if (!first.second)
+			{
+				++m_statistics.hits;
+				duplicates.emplace_back(i, first.first->second);
+				continue;
+			}
+
+			++m_statistics.misses;
+			pending.emplace_back(i, decodeTexture(files[i]));
+		}
+	}
+
+	for (auto& decode : pending)
+	{
+		auto& file = files[decode.first];
+		auto texture = decode.second.get();
+
+		// another batch may have loaded the same path in the meantime
+		if (!(textures[decode.first] = find(file)))
+		{
+			textures[decode.first] = insert(file, std::move(texture));
+		}
+	}
+
+	for (auto& duplicate : duplicates)
+	{
+		textures[duplicate.first] = textures[duplicate.second];
+	}
+
+	return textures;
+}
+
+TextureCache::Statistics TextureCache::statistics(void) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_statistics;
+}
+
+TextureCache::TexturePtr TextureCache::find(const std::string& file)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto it = m_textures.find(file);
+
+	if (it == m_textures.end())
+		return nullptr;
+
+	return it->second.lock();
+}
+
+TextureCache::TexturePtr TextureCache::insert(const std::string& file, std::unique_ptr<GxmTexture> texture)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	TexturePtr ptr(texture.release(), [this, file](const GxmTexture *texture)
+	{
+		this->release(file, texture);
+	});
+
+	m_statistics.bytesResident += ptr->storageSize();
+	m_textures[file] = ptr;
+	return ptr;
+}
+
+void TextureCache::release(const std::string& file, const GxmTexture *texture)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_statistics.bytesResident -= texture->storageSize();
+
+		auto it = m_textures.find(file);
+
+		// the path may have been loaded again since the last handle went away
+		if (it != m_textures.end() && it->second.expired())
+		{
+			m_textures.erase(it);
+		}
+	}
+
+	delete texture;
+}
@@ -0,0 +1,59 @@
+/*
+ * texturecache.h - share decoded textures between their users
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include <framework/gxmtexture.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// decodes each texture path once. the cache only holds weak references, so
+// the gpu storage is released as soon as the last user drops its handle
+class TextureCache
+{
+public:
+	using TexturePtr = std::shared_ptr<const GxmTexture>;
+
+	struct Statistics
+	{
+		unsigned int hits;
+		unsigned int misses;
+		std::size_t bytesResident;
+	};
+
+public:
+	static TextureCache *instance(void);
+
+	TexturePtr texture(const std::string& file);
+
+	// any textures not already resident are decoded in parallel, a path
+	// given more than once only the once
+	std::vector<TexturePtr> textures(const std::vector<std::string>& files);
+
+	Statistics statistics(void) const;
+
+private:
+	TextureCache(void) = default;
+
+	TexturePtr find(const std::string& file);
+	TexturePtr insert(const std::string& file, std::unique_ptr<GxmTexture> texture);
+	void release(const std::string& file, const GxmTexture *texture);
+
+private:
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, std::weak_ptr<const GxmTexture>> m_textures;
+	Statistics m_statistics{0, 0, 0};
+};
+
+#endif // TEXTURECACHE_H
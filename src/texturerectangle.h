@@ -10,11 +10,14 @@
 #ifndef TEXTURERECTANGLE_H
 #define TEXTURERECTANGLE_H
 
-#include <framework/gpumemoryblock.h>
+#include <framework/framering.h>
+#include <framework/quadindexbuffer.h>
 #include <framework/gxmtexture.h>
 
 #include <glm/gtx/transform.hpp>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include "geometry.h"
 
@@ -52,13 +55,9 @@ private:
 	void doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const override;
 
 private:
-	std::unique_ptr<GpuMemoryBlock<Vertex>> m_vertices;
-	std::unique_ptr<GpuMemoryBlock<uint16_t>> m_indices;
-
-	Vertex *m_topLeft;
-	Vertex *m_topRight;
-	Vertex *m_bottomLeft;
-	Vertex *m_bottomRight;
+	// bottom left, bottom right, top left, top right. these are copied to
+	// the frame ring each draw, so they can change while on screen
+	Vertex m_vertices[4]{};
 
 	float m_width, m_height;
 	glm::mat4 m_model;
@@ -69,39 +68,15 @@ private:
 template <typename Vertex>
 TextureRectangle<Vertex>::TextureRectangle(void)
 {
-	m_vertices = std::make_unique<GpuMemoryBlock<Vertex>>
-	(
-		4,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_indices = std::make_unique<GpuMemoryBlock<uint16_t>>
-	(
-		6,
-		SCE_GXM_MEMORY_ATTRIB_READ
-	);
-
-	m_bottomLeft = &m_vertices->address()[0];
-	m_bottomRight = &m_vertices->address()[1];
-	m_topLeft = &m_vertices->address()[2];
-	m_topRight = &m_vertices->address()[3];
-	
-	m_bottomLeft->position = glm::vec3(-1, -1, 0);
-	m_bottomRight->position = glm::vec3(1, -1, 0);
-	m_topLeft->position = glm::vec3(-1, 1, 0);
-	m_topRight->position = glm::vec3(1, 1, 0);
-
-	m_bottomLeft->texCoord = glm::vec2(0, 1);
-	m_bottomRight->texCoord = glm::vec2(1, 1);
-	m_topLeft->texCoord = glm::vec2(0, 0);
-	m_topRight->texCoord = glm::vec2(1, 0);
-
-	m_indices->address()[0] = 0;
-	m_indices->address()[1] = 1;
-	m_indices->address()[2] = 2;
-	m_indices->address()[3] = 1;
-	m_indices->address()[4] = 3;
-	m_indices->address()[5] = 2;
+	m_vertices[0].position = glm::vec3(-1, -1, 0);
+	m_vertices[1].position = glm::vec3(1, -1, 0);
+	m_vertices[2].position = glm::vec3(-1, 1, 0);
+	m_vertices[3].position = glm::vec3(1, 1, 0);
+
+	m_vertices[0].texCoord = glm::vec2(0, 1);
+	m_vertices[1].texCoord = glm::vec2(1, 1);
+	m_vertices[2].texCoord = glm::vec2(0, 0);
+	m_vertices[3].texCoord = glm::vec2(1, 0);
 
 	setWidth(1.f);
 	setHeight(1.f);
@@ -142,40 +117,38 @@ template <typename Vertex>
 template <typename Colour>
 void TextureRectangle<Vertex>::setBottomLeftColour(Colour colour)
 {
-	m_bottomLeft->colour = colour;
+	m_vertices[0].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void TextureRectangle<Vertex>::setBottomRightColour(Colour colour)
 {
-	m_bottomRight->colour = colour;
+	m_vertices[1].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void TextureRectangle<Vertex>::setTopLeftColour(Colour colour)
 {
-	m_topLeft->colour = colour;
+	m_vertices[2].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void TextureRectangle<Vertex>::setTopRightColour(Colour colour)
 {
-	m_topRight->colour = colour;
+	m_vertices[3].colour = colour;
 }
 
 template <typename Vertex>
 template <typename Colour>
 void TextureRectangle<Vertex>::setColour(Colour colour)
 {
-	auto vertices = m_vertices->address();
-
 	// apply colour to all vertices
-	for (auto i = 0u; i < m_vertices->count(); ++i)
+	for (auto& vertex : m_vertices)
 	{
-		vertices[i].colour = colour;
+		vertex.colour = colour;
 	}
 }
 
@@ -189,8 +162,11 @@ template <typename Vertex>
 void TextureRectangle<Vertex>::doDraw(SceGxmContext *ctx, const GeometryRenderer *renderer, const Camera *camera) const
 {
 	m_texture->bind(ctx, 0);
-	sceGxmSetVertexStream(ctx, 0, m_vertices->address());
-	sceGxmDraw(ctx, SCE_GXM_PRIMITIVE_TRIANGLES, SCE_GXM_INDEX_FORMAT_U16, m_indices->address(), m_indices->count());
+	auto vertices = FrameRing::instance()->allocate<Vertex>(4);
+	std::copy(std::begin(m_vertices), std::end(m_vertices), vertices);
+
+	sceGxmSetVertexStream(ctx, 0, vertices);
+	QuadIndexBuffer::instance()->draw(ctx, 0, 1);
 }
 
 #endif // TEXTURERECTANGLE_H
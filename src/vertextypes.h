@@ -12,9 +12,14 @@
 
 #include <framework/gxmvertexshader.h>
 
+#include <glm/packing.hpp>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 #include <psp2/gxm.h>
@@ -98,4 +103,183 @@ struct ColouredTextureVertex
 	}
 };
 
+// the ui is flat, so compact vertices keep only x and y of a position, as
+// half floats. these take the same glm types as the full precision members
+// so the geometry templates can fill either
+struct PackedPosition
+{
+	PackedPosition& operator=(const glm::vec3& position)
+	{
+		value = glm::packHalf2x16(glm::vec2(position));
+		return *this;
+	}
+
+	std::uint32_t value;
+};
+
+// 16 bit normalised, for coordinates within a texture
+struct PackedTexCoord
+{
+	PackedTexCoord& operator=(const glm::vec2& texCoord)
+	{
+		value = glm::packUnorm2x16(texCoord);
+		return *this;
+	}
+
+	std::uint32_t value;
+};
+
+// 8 bit normalised, the precision of the screen anyway
+struct PackedColour
+{
+	PackedColour& operator=(const glm::vec4& colour)
+	{
+		value = glm::packUnorm4x8(colour);
+		return *this;
+	}
+
+	std::uint32_t value;
+};
+
+// text is laid out with fractional metrics across the whole screen, where
+// half floats drop to half a pixel. glyphs are placed in quarter units
+// instead, which the text shaders scale back down, so a line can run for
+// 8192 units either side of its origin
+struct FixedPosition
+{
+	static constexpr float SCALE = 4.f;
+
+	FixedPosition& operator=(const glm::vec2& position)
+	{
+		x = fixed(position.x);
+		y = fixed(position.y);
+		return *this;
+	}
+
+	static std::int16_t fixed(float value)
+	{
+		auto scaled = std::lround(value*SCALE);
+		return static_cast<std::int16_t>(std::max<long>(INT16_MIN, std::min<long>(INT16_MAX, scaled)));
+	}
+
+	std::int16_t x, y;
+};
+
+struct CompactGeometryVertex
+{
+	PackedPosition position;
+	PackedColour colour;
+
+	static std::vector<SceGxmVertexAttribute> attributes(GxmVertexShader *vertexShader)
+	{
+		std::vector<SceGxmVertexAttribute> attributes(2);
+		attributes[0].streamIndex = 0;
+		attributes[0].offset = offsetof(CompactGeometryVertex, position);
+		attributes[0].format = SCE_GXM_ATTRIBUTE_FORMAT_F16;
+		attributes[0].componentCount = 2;
+		attributes[0].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("position"));
+
+		attributes[1].streamIndex = 0;
+		attributes[1].offset = offsetof(CompactGeometryVertex, colour);
+		attributes[1].format = SCE_GXM_ATTRIBUTE_FORMAT_U8N;
+		attributes[1].componentCount = 4;
+		attributes[1].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("colour"));
+		return attributes;
+	}
+
+	static std::vector<SceGxmVertexStream> streams(void)
+	{
+		std::vector<SceGxmVertexStream> streams(1);
+		streams[0].stride = sizeof(CompactGeometryVertex);
+		streams[0].indexSource = SCE_GXM_INDEX_SOURCE_INDEX_16BIT;
+		return streams;
+	}
+	
+	constexpr static int streamCount(void)
+	{
+		return 1;
+	}
+};
+
+struct CompactTextureVertex
+{
+	PackedPosition position;
+	PackedTexCoord texCoord;
+	PackedColour colour;
+
+	static std::vector<SceGxmVertexAttribute> attributes(GxmVertexShader *vertexShader)
+	{
+		std::vector<SceGxmVertexAttribute> attributes(3);
+		attributes[0].streamIndex = 0;
+		attributes[0].offset = offsetof(CompactTextureVertex, position);
+		attributes[0].format = SCE_GXM_ATTRIBUTE_FORMAT_F16;
+		attributes[0].componentCount = 2;
+		attributes[0].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("position"));
+
+		attributes[1].streamIndex = 0;
+		attributes[1].offset = offsetof(CompactTextureVertex, texCoord);
+		attributes[1].format = SCE_GXM_ATTRIBUTE_FORMAT_U16N;
+		attributes[1].componentCount = 2;
+		attributes[1].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("texCoord"));
+
+		attributes[2].streamIndex = 0;
+		attributes[2].offset = offsetof(CompactTextureVertex, colour);
+		attributes[2].format = SCE_GXM_ATTRIBUTE_FORMAT_U8N;
+		attributes[2].componentCount = 4;
+		attributes[2].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("colour"));
+		return attributes;
+	}
+
+	static std::vector<SceGxmVertexStream> streams(void)
+	{
+		std::vector<SceGxmVertexStream> streams(1);
+		streams[0].stride = sizeof(CompactTextureVertex);
+		streams[0].indexSource = SCE_GXM_INDEX_SOURCE_INDEX_16BIT;
+		return streams;
+	}
+	
+	constexpr static int streamCount(void)
+	{
+		return 1;
+	}
+};
+
+// text is coloured per draw, see GeometryRenderer::setColour. every glyph
+// is flat and samples within the atlas, so text only has a compact form
+struct TextVertex
+{
+	FixedPosition position;
+	PackedTexCoord texCoord;
+
+	static std::vector<SceGxmVertexAttribute> attributes(GxmVertexShader *vertexShader)
+	{
+		std::vector<SceGxmVertexAttribute> attributes(2);
+		attributes[0].streamIndex = 0;
+		attributes[0].offset = offsetof(TextVertex, position);
+		attributes[0].format = SCE_GXM_ATTRIBUTE_FORMAT_S16;
+		attributes[0].componentCount = 2;
+		attributes[0].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("position"));
+
+		attributes[1].streamIndex = 0;
+		attributes[1].offset = offsetof(TextVertex, texCoord);
+		attributes[1].format = SCE_GXM_ATTRIBUTE_FORMAT_U16N;
+		attributes[1].componentCount = 2;
+		attributes[1].regIndex = sceGxmProgramParameterGetResourceIndex(vertexShader->attributeIndex("texCoord"));
+		return attributes;
+	}
+
+	static std::vector<SceGxmVertexStream> streams(void)
+	{
+		std::vector<SceGxmVertexStream> streams(1);
+		streams[0].stride = sizeof(TextVertex);
+		streams[0].indexSource = SCE_GXM_INDEX_SOURCE_INDEX_16BIT;
+		return streams;
+	}
+	
+	constexpr static int streamCount(void)
+	{
+		return 1;
+	}
+};
+
 #endif // VERTEXTYPES_H
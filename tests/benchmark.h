@@ -0,0 +1,67 @@
+/*
+ * benchmark.h - timing helpers for the host benchmarks
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+
+namespace Benchmark
+{
+	// stops the compiler from throwing away work whose result is unused
+	template <typename T>
+	inline void keep(const T& value)
+	{
+		asm volatile("" : : "g"(&value) : "memory");
+	}
+
+	// nanoseconds per iteration, the best of a few runs so a stray context
+	// switch does not count against it
+	template <typename Fn>
+	double measure(unsigned int iterations, Fn fn)
+	{
+		auto best = std::numeric_limits<double>::max();
+
+		for (auto run = 0; run < 5; ++run)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			for (auto i = 0u; i < iterations; ++i)
+			{
+				fn(i);
+			}
+
+			std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+			best = std::min(best, elapsed.count()/iterations);
+		}
+
+		return best;
+	}
+
+	inline void report(const char *name, double nanoseconds)
+	{
+		if (nanoseconds >= 1e6)
+		{
+			std::printf("%-48s %12.2f ms\n", name, nanoseconds/1e6);
+		}
+		else if (nanoseconds >= 1e3)
+		{
+			std::printf("%-48s %12.2f us\n", name, nanoseconds/1e3);
+		}
+		else
+		{
+			std::printf("%-48s %12.1f ns\n", name, nanoseconds);
+		}
+	}
+}
+
+#endif // BENCHMARK_H
@@ -0,0 +1,319 @@
+/*
+ * characteratlastest.cpp - glyph atlas growth, eviction and repacking
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <characteratlas.h>
+
+#include "test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+namespace
+{
+	// the layout GlyphStore keeps on disk, read back to see the pages
+	struct SavedAtlas
+	{
+		std::uint32_t pageSize;
+		std::uint32_t pageCount;
+		std::uint32_t glyphCount;
+		std::uint32_t glyphOffset;
+	};
+
+	struct SavedPage
+	{
+		std::uint32_t rows;
+		std::uint32_t bitmapOffset;
+		std::uint32_t skylineCount;
+		std::uint32_t skylineOffset;
+	};
+
+	struct SavedGlyph
+	{
+		std::uint32_t character;
+		std::uint32_t page;
+		std::int32_t x, y, width, height;
+		float advanceX, advanceY;
+		float left, top;
+	};
+
+	constexpr unsigned int CJK_FIRST = 0x4E00;
+	constexpr std::size_t PAGE_BUDGET = 2;
+
+	// there is no CJK font to rasterise, so every glyph is a full width
+	// bitmap with pixels only its own codepoint would have
+	std::size_t glyphWidth(unsigned int character)
+	{
+		return 18 + character%7;
+	}
+
+	std::size_t glyphRows(unsigned int character)
+	{
+		return 20 + character%5;
+	}
+
+	char glyphPixel(unsigned int character, std::size_t x, std::size_t y)
+	{
+		return static_cast<char>(1 + (character*31 + x*7 + y*13)%255);
+	}
+
+	bool addGlyph(CharacterAtlas& atlas, unsigned int character)
+	{
+		auto width = glyphWidth(character);
+		auto rows = glyphRows(character);
+		std::vector<char> bitmap(width*rows);
+
+		for (auto y = 0u; y < rows; ++y)
+		{
+			for (auto x = 0u; x < width; ++x)
+			{
+				bitmap[y*width + x] = glyphPixel(character, x, y);
+			}
+		}
+
+		return atlas.addGlyph(character, bitmap.data(), width, rows, width, glm::vec2(width+2, 0), 1, rows-2);
+	}
+
+	// what a text renderer does for a line of text
+	unsigned int draw(CharacterAtlas& atlas, const std::vector<unsigned int>& text)
+	{
+		auto missing = 0u;
+
+		for (auto character : text)
+		{
+			if (!atlas.contains(character) && !addGlyph(atlas, character))
+			{
+				++missing;
+			}
+		}
+
+		for (auto character : text)
+		{
+			atlas.glyphInfo(character);
+		}
+
+		return missing;
+	}
+
+	// every glyph left in the atlas has its own bitmap, in a region no other
+	// glyph on the page overlaps. the text just drawn has info that points at
+	// its region, looking the rest up would keep them from being evicted
+	void checkPages(CharacterAtlas& atlas, const std::vector<unsigned int>& text)
+	{
+		auto data = atlas.save();
+		SavedAtlas saved;
+		std::memcpy(&saved, data.data(), sizeof(saved));
+
+		CHECK(saved.pageCount <= PAGE_BUDGET);
+		CHECK(saved.glyphCount == atlas.statistics().glyphs);
+
+		std::vector<SavedPage> pages(saved.pageCount);
+		std::memcpy(pages.data(), data.data() + sizeof(SavedAtlas), pages.size()*sizeof(SavedPage));
+
+		std::vector<SavedGlyph> glyphs(saved.glyphCount);
+		std::memcpy(glyphs.data(), data.data() + saved.glyphOffset, glyphs.size()*sizeof(SavedGlyph));
+
+		std::vector<std::vector<bool>> covered(saved.pageCount, std::vector<bool>(CharacterAtlas::PAGE_SIZE*CharacterAtlas::PAGE_SIZE));
+		auto overlaps = 0u, corrupt = 0u, misplaced = 0u;
+
+		for (auto& glyph : glyphs)
+		{
+			if (!CHECK(glyph.page < saved.pageCount))
+				continue;
+
+			auto& page = pages[glyph.page];
+			auto bitmap = data.data() + page.bitmapOffset;
+
+			// the border a region carries is its own too
+			for (auto y = glyph.y; y < glyph.y + glyph.height; ++y)
+			{
+				for (auto x = glyph.x; x < glyph.x + glyph.width; ++x)
+				{
+					auto pixel = covered[glyph.page].begin() + y*CharacterAtlas::PAGE_SIZE + x;
+					overlaps += *pixel;
+					*pixel = true;
+				}
+			}
+
+			if (glyph.character < CJK_FIRST)
+				continue;
+
+			if (static_cast<std::size_t>(glyph.width-1) != glyphWidth(glyph.character)
+				|| static_cast<std::size_t>(glyph.height-1) != glyphRows(glyph.character)
+				|| static_cast<std::uint32_t>(glyph.y + glyph.height-1) > page.rows)
+			{
+				++corrupt;
+				continue;
+			}
+
+			for (auto y = 0; y < glyph.height-1; ++y)
+			{
+				for (auto x = 0; x < glyph.width-1; ++x)
+				{
+					corrupt += bitmap[(glyph.y + y)*CharacterAtlas::PAGE_SIZE + glyph.x + x] != glyphPixel(glyph.character, x, y);
+				}
+			}
+
+			if (std::find(text.begin(), text.end(), glyph.character) == text.end())
+				continue;
+
+			auto info = atlas.find(glyph.character);
+
+			if (!info || info->page != glyph.page
+				|| info->quad.tl.x*CharacterAtlas::PAGE_SIZE != glyph.x || info->quad.tl.y*CharacterAtlas::PAGE_SIZE != glyph.y
+				|| info->quad.size.x != glyph.width || info->quad.size.y != glyph.height)
+			{
+				++misplaced;
+			}
+		}
+
+		CHECK(overlaps == 0);
+		CHECK(corrupt == 0);
+		CHECK(misplaced == 0);
+	}
+} // anonymous namespace
+
+int main(void)
+{
+	CharacterAtlas atlas(GxmTexture::Point, PAGE_BUDGET);
+	auto generation = atlas.generation();
+
+	// a page of text slides through the unified ideographs, a third new
+	// characters each frame, with some latin that is always on screen
+	constexpr auto FRAMES = 60;
+	constexpr auto TEXT_LENGTH = 300;
+	constexpr auto STEP = TEXT_LENGTH/3;
+
+	auto maxPages = 0u;
+	auto position = 0u;
+	auto missed = 0u;
+	auto missedLast = 0u;
+
+	// the text of the frames the gpu may still be drawing
+	std::deque<std::vector<unsigned int>> queued;
+
+	for (auto frame = 0; frame < FRAMES; ++frame)
+	{
+		CharacterAtlas::nextFrame();
+
+		std::vector<unsigned int> text;
+
+		for (auto c = '0'; c <= '9'; ++c)
+		{
+			text.push_back(c);
+		}
+
+		for (auto i = 0; i < TEXT_LENGTH; ++i)
+		{
+			text.push_back(CJK_FIRST + position*STEP + i);
+		}
+
+		// once the pages run out the new glyphs wait a frame for room, the
+		// same text is shown again until they have it
+		auto missing = draw(atlas, text);
+		CHECK(!missing || !missedLast);
+
+		missed += missing != 0;
+		missedLast = missing;
+		position += !missing;
+
+		queued.push_back(text);
+
+		if (queued.size() > CharacterAtlas::COLD_FRAMES+1)
+			queued.pop_front();
+
+		auto statistics = atlas.statistics();
+		maxPages = std::max<unsigned int>(maxPages, statistics.pages);
+
+		CHECK(statistics.pages <= PAGE_BUDGET);
+		checkPages(atlas, text);
+
+		// between frames. nothing drawn in a frame still queued for the gpu
+		// is evicted
+		CHECK(atlas.collect() == (missing != 0));
+
+		auto lost = 0u;
+
+		for (auto& shown : queued)
+		{
+			for (auto character : shown)
+			{
+				lost += !atlas.contains(character);
+			}
+		}
+
+		CHECK(lost == missing);
+	}
+
+	auto statistics = atlas.statistics();
+
+	CHECK(maxPages == PAGE_BUDGET);
+	CHECK(missed > 0);
+	CHECK(statistics.evictions > 0);
+	CHECK(statistics.rasterizations == 10 + TEXT_LENGTH + (position-1)*STEP + (missedLast ? STEP-missedLast : 0));
+	CHECK(atlas.generation() != generation);
+
+	// text from long ago has made room for the rest
+	CHECK(!atlas.contains(CJK_FIRST));
+	CHECK(atlas.find(CJK_FIRST) == nullptr);
+
+	// nothing has failed to fit since the last collect
+	CHECK(!atlas.collect());
+
+	// more new glyphs in one frame than the pages hold: the atlas refuses
+	// the ones that do not fit rather than evict any in use
+	CharacterAtlas::nextFrame();
+
+	std::vector<unsigned int> flood;
+
+	for (auto i = 0u; i < 2000; ++i)
+	{
+		flood.push_back(CJK_FIRST + 0x4000 + i);
+	}
+
+	generation = atlas.generation();
+	auto missing = draw(atlas, flood);
+
+	CHECK(missing > 0 && missing < flood.size());
+	CHECK(atlas.statistics().pages == PAGE_BUDGET);
+	CHECK(atlas.generation() == generation);
+	checkPages(atlas, flood);
+
+	// the flood is hot until every frame it was drawn in is done, after that
+	// it is fair game
+	atlas.collect();
+
+	for (auto i = 0u; i < CharacterAtlas::COLD_FRAMES; ++i)
+	{
+		CharacterAtlas::nextFrame();
+		CHECK(!atlas.collect());
+	}
+
+	CharacterAtlas::nextFrame();
+
+	std::vector<unsigned int> next;
+
+	for (auto i = 0u; i < 2000; ++i)
+	{
+		next.push_back(CJK_FIRST + 0x5000 + i);
+	}
+
+	CHECK(draw(atlas, next) > 0);
+	checkPages(atlas, next);
+
+	auto held = std::count_if(next.begin(), next.end(), [&](unsigned int character) { return atlas.contains(character); });
+
+	CHECK(atlas.collect());
+	CHECK(std::none_of(flood.begin(), flood.end(), [&](unsigned int character) { return atlas.contains(character); }));
+	CHECK(std::count_if(next.begin(), next.end(), [&](unsigned int character) { return atlas.contains(character); }) == held);
+
+	return Test::result();
+}
@@ -0,0 +1,127 @@
+/*
+ * fontcachetest.cpp - glyph atlases saved for the next launch
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <fontcache.h>
+
+#include <freetype2/ft2build.h>
+#include FT_FREETYPE_H
+
+#include "test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace
+{
+	const std::string FONT = "rsc:/fonts/DroidSans.ttf";
+	constexpr std::uint64_t FONT_HASH = 0x1234;
+
+	// each store is a new launch, not the one the font cache shares. the
+	// size is one the build did not bake, so every glyph is rasterised
+	std::unique_ptr<GlyphStore> store(void)
+	{
+		FT_Library library = nullptr;
+		FT_Init_FreeType(&library);
+
+		auto cache = FontCache::instance();
+		return std::make_unique<GlyphStore>(std::shared_ptr<FT_LibraryRec_>(library, FT_Done_FreeType), cache->fontData(FONT), cache->bakedGlyphs(FONT), 30.f, false);
+	}
+
+	bool exists(const std::string& filename)
+	{
+		return std::ifstream(filename).good();
+	}
+
+	long fileSize(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		return file.good() ? static_cast<long>(file.tellg()) : -1;
+	}
+
+	// the atlas is written on the background scheduler, a save with more
+	// glyphs makes a larger file
+	bool waitFor(const std::string& filename, long previousSize)
+	{
+		for (auto i = 0; i < 500; ++i)
+		{
+			if (!exists(filename + ".tmp") && fileSize(filename) > previousSize)
+				return true;
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+
+		return false;
+	}
+
+	// rasterises text then saves once it has been quiet for a call
+	void save(GlyphStore *glyphs, const char *text)
+	{
+		for (auto c = text; *c; ++c)
+		{
+			glyphs->glyphInfo(*c);
+		}
+
+		glyphs->saveCache();
+		glyphs->saveCache();
+	}
+} // anonymous namespace
+
+int main(void)
+{
+	auto filename = std::string("fontcachetest.glyphcache");
+
+	std::remove(filename.c_str());
+	std::remove((filename + ".tmp").c_str());
+
+	// nothing saved yet
+	auto first = store();
+
+	CHECK(first->good());
+	CHECK(!first->loadCache(filename, FONT_HASH));
+
+	save(first.get(), "abc");
+	CHECK(waitFor(filename, -1));
+
+	auto saved = first->atlas()->statistics().glyphs;
+
+	// a later save replaces the file it made
+	auto size = fileSize(filename);
+
+	save(first.get(), "xyz");
+	CHECK(waitFor(filename, size));
+
+	auto second = store();
+
+	CHECK(second->loadCache(filename, FONT_HASH));
+	CHECK(second->atlas()->statistics().glyphs == saved + 3);
+	CHECK(second->atlas()->contains('x'));
+
+	// a save cut short once the old file was moved aside leaves only the
+	// temporary file, which the next launch loads instead
+	std::rename(filename.c_str(), (filename + ".tmp").c_str());
+
+	auto third = store();
+
+	CHECK(third->loadCache(filename, FONT_HASH));
+	CHECK(third->atlas()->contains('a') && third->atlas()->contains('z'));
+
+	// and a cache from other font data is never used
+	auto other = store();
+
+	CHECK(!other->loadCache(filename, FONT_HASH+1));
+
+	std::remove(filename.c_str());
+	std::remove((filename + ".tmp").c_str());
+
+	return Test::result();
+}
@@ -0,0 +1,233 @@
+/*
+ * glyphbenchmark.cpp - glyph info lookups for a page of text
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <font.h>
+#include <fontcache.h>
+
+#include <utf8cpp/utf8.h>
+
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// the text of every page of the installer
+	const char *strings[] =
+	{
+		"Welcome to HENkaku!", "Press right to continue.", "Select an option:",
+		"Simple Installation", "Enables homebrews. Advanced features disabled to protect your device.",
+		"Advanced Installation", "Only for advanced users. Enable potentially dangerous options.",
+		"Configuration", "Enable support for plugins and unsafe homebrew",
+		"Unstable or malicious content can permanently damage your Vita!",
+		"Enable version spoofing to block update prompts",
+		"Spoofing only prevents accidental updates. It won't enable 3.61+ games",
+		"Offline HENkaku", "Would you like to use the HENkaku offline enabler",
+		"from the Email application? Check out", "https://henkaku.xyz/usage for details",
+		"Yes, install offline HENkaku", "Reset", "Would you like to reset all HENkaku and taiHEN data?",
+		"Your games and installed homebrew should", "not be affected.", "Yes, reset my configuration",
+		"Confirm Installation", "You are installing HENkaku with the following options:",
+		"Reset all HENkaku and taiHEN data", "Enable plugins and unsafe homebrew",
+		"Enable version spoofing to prevent updates", "Install HENkaku offline enabler",
+		"Press X to continue.", "FPS: 59.94", "Caf\xc3\xa9 \xc2\xa9 2016"
+	};
+
+	using Page = std::vector<std::vector<unsigned int>>;
+
+	Page latinPage(void)
+	{
+		Page page;
+
+		for (auto string : strings)
+		{
+			std::vector<unsigned int> characters;
+			std::string text(string);
+			utf8::utf8to32(text.begin(), text.end(), std::back_inserter(characters));
+			page.push_back(characters);
+		}
+
+		return page;
+	}
+
+	// the same page with its letters moved to cyrillic, which is outside
+	// the dense table
+	Page cyrillicPage(void)
+	{
+		auto page = latinPage();
+
+		for (auto& line : page)
+		{
+			for (auto& character : line)
+			{
+				if (character >= 'a' && character <= 'z')
+					character = 0x430 + (character - 'a');
+				else if (character >= 'A' && character <= 'Z')
+					character = 0x410 + (character - 'A');
+			}
+		}
+
+		return page;
+	}
+
+	std::size_t characterCount(const Page& page)
+	{
+		std::size_t count = 0;
+
+		for (auto& line : page)
+		{
+			count += line.size();
+		}
+
+		return count;
+	}
+
+	// what CharacterAtlas used to keep: the region of each glyph in a map,
+	// checked for and then looked up again, with the quad worked out from
+	// the region on every call. kept out of line, as it was in its own file
+	struct OldGlyph
+	{
+		glm::ivec4 region;
+		glm::vec2 advance;
+		float left;
+		float top;
+	};
+
+	class OldAtlas
+	{
+	public:
+		void insert(unsigned int character, const CharacterAtlas::GlyphInfo& info)
+		{
+			auto size = static_cast<float>(CharacterAtlas::PAGE_SIZE);
+			auto region = glm::ivec4(info.quad.tl.x*size, info.quad.tl.y*size, info.quad.size.x, info.quad.size.y);
+			m_glyphs[character] = { region, info.advance, info.bitmap_left, info.bitmap_top };
+		}
+
+		bool contains(unsigned int character) const
+		{
+			return m_glyphs.find(character) != m_glyphs.end();
+		}
+
+		__attribute__((noinline)) CharacterAtlas::GlyphInfo glyphInfo(unsigned int character) const
+		{
+			CharacterAtlas::GlyphInfo info;
+
+			if (!contains(character))
+				return info;
+
+			auto glyph = m_glyphs.at(character);
+			auto size = static_cast<float>(CharacterAtlas::PAGE_SIZE);
+			auto uv = glm::vec4(glyph.region.x/size, glyph.region.y/size, glyph.region.z/size, glyph.region.w/size);
+
+			info.quad.tl = glm::vec2(uv.x, uv.y);
+			info.quad.tr = glm::vec2(uv.x+uv.z, uv.y);
+			info.quad.bl = glm::vec2(uv.x, uv.y+uv.w);
+			info.quad.br = glm::vec2(uv.x+uv.z, uv.y+uv.w);
+			info.quad.size = glm::vec2(glyph.region.z, glyph.region.w);
+			info.advance = glyph.advance;
+			info.bitmap_left = glyph.left;
+			info.bitmap_top = glyph.top;
+			return info;
+		}
+
+	private:
+		std::unordered_map<unsigned int, OldGlyph> m_glyphs;
+	};
+
+	template <typename Lookup>
+	void measurePage(const char *name, const Page& page, Lookup lookup)
+	{
+		const unsigned int ITERATIONS = 2000;
+
+		auto perPage = Benchmark::measure(ITERATIONS, [&](unsigned int)
+		{
+			for (auto& line : page)
+			{
+				for (auto character : line)
+				{
+					auto info = lookup(character);
+					Benchmark::keep(info);
+				}
+			}
+		});
+
+		Benchmark::report(name, perPage/characterCount(page));
+	}
+}
+
+int main(void)
+{
+	Font font("rsc:/fonts/DroidSans.ttf");
+	font.setPointSize(20.f);
+
+	Font distanceField("rsc:/fonts/DroidSans.ttf");
+	distanceField.setPointSize(12.f);
+	distanceField.setDistanceField(true);
+
+	auto latin = latinPage();
+	auto cyrillic = cyrillicPage();
+
+	// every glyph is in the atlas before anything is timed
+	OldAtlas oldAtlas;
+
+	for (auto page : { &latin, &cyrillic })
+	{
+		for (auto& line : *page)
+		{
+			for (auto character : line)
+			{
+				oldAtlas.insert(character, font.glyphInfo(character));
+				distanceField.glyphInfo(character);
+			}
+		}
+	}
+
+	auto atlas = FontCache::instance()->glyphStore("rsc:/fonts/DroidSans.ttf", 20.f)->atlas();
+
+	std::printf("%zu strings, %zu characters, per character:\n", latin.size(), characterCount(latin));
+
+	measurePage("latin: map, contains then at, toQuad (before)", latin, [&](unsigned int character)
+	{
+		return oldAtlas.glyphInfo(character);
+	});
+
+	measurePage("latin: CharacterAtlas::glyphInfo, dense table", latin, [&](unsigned int character)
+	{
+		return atlas->glyphInfo(character);
+	});
+
+	measurePage("latin: Font::glyphInfo", latin, [&](unsigned int character)
+	{
+		return font.glyphInfo(character);
+	});
+
+	measurePage("latin: Font::glyphInfo, distance field", latin, [&](unsigned int character)
+	{
+		return distanceField.glyphInfo(character);
+	});
+
+	measurePage("cyrillic: map, contains then at, toQuad (before)", cyrillic, [&](unsigned int character)
+	{
+		return oldAtlas.glyphInfo(character);
+	});
+
+	measurePage("cyrillic: CharacterAtlas::glyphInfo, hash map", cyrillic, [&](unsigned int character)
+	{
+		return atlas->glyphInfo(character);
+	});
+
+	measurePage("cyrillic: Font::glyphInfo", cyrillic, [&](unsigned int character)
+	{
+		return font.glyphInfo(character);
+	});
+
+	return 0;
+}
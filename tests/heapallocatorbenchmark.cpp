@@ -0,0 +1,108 @@
+/*
+ * heapallocatorbenchmark.cpp - gpu heap allocation speed against malloc
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <framework/heapallocator.h>
+
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t LIVE_COUNT = 2000;
+	constexpr std::size_t OPERATIONS = 100000;
+
+	// which buffer is replaced next and how large the new one is: vertex and
+	// index buffers of a few dozen to a few hundred bytes
+	struct Churn
+	{
+		std::vector<unsigned int> index;
+		std::vector<unsigned int> size;
+	};
+
+	Churn churn(unsigned int seed)
+	{
+		Churn result;
+
+		for (auto i = 0u; i < OPERATIONS; ++i)
+		{
+			seed = seed*1103515245 + 12345;
+			result.index.push_back((seed >> 8)%LIVE_COUNT);
+			seed = seed*1103515245 + 12345;
+			result.size.push_back(16 + (seed >> 16)%300);
+		}
+
+		return result;
+	}
+} // anonymous namespace
+
+int main(void)
+{
+	const unsigned int ITERATIONS = 20;
+
+	auto operations = churn(1);
+
+	HeapAllocator allocator;
+	allocator.addRegion(0x10000, 1 << 20);
+
+	std::vector<HeapAllocator::Handle> handles(LIVE_COUNT);
+
+	for (auto i = 0u; i < LIVE_COUNT; ++i)
+	{
+		handles[i] = allocator.allocate(operations.size[i]);
+	}
+
+	auto heap = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		for (auto i = 0u; i < OPERATIONS; ++i)
+		{
+			auto& handle = handles[operations.index[i]];
+			allocator.free(handle);
+			handle = allocator.allocate(operations.size[i]);
+		}
+	});
+
+	std::vector<void *> blocks(LIVE_COUNT);
+
+	for (auto i = 0u; i < LIVE_COUNT; ++i)
+	{
+		blocks[i] = std::malloc(operations.size[i]);
+	}
+
+	auto system = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		for (auto i = 0u; i < OPERATIONS; ++i)
+		{
+			auto& block = blocks[operations.index[i]];
+			std::free(block);
+			block = std::malloc(operations.size[i]);
+			Benchmark::keep(block);
+		}
+	});
+
+	auto statistics = allocator.statistics();
+
+	std::printf("%zu live buffers of 16 to 315 bytes, one replaced at a time\n", LIVE_COUNT);
+	Benchmark::report("free then allocate: HeapAllocator", heap/OPERATIONS);
+	Benchmark::report("free then allocate: malloc", system/OPERATIONS);
+	std::printf("heap: %zu of %zu bytes used in %u blocks, %u free blocks, %.1f%% fragmented\n",
+		statistics.usedBytes,
+		statistics.totalBytes,
+		statistics.allocations,
+		statistics.freeBlocks,
+		100.f*statistics.fragmentation);
+
+	for (auto block : blocks)
+	{
+		std::free(block);
+	}
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * heapallocatortest.cpp - gpu heap sub-allocation
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/gpuheap.h>
+#include <framework/heapallocator.h>
+
+#include "test.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	constexpr std::uintptr_t FIRST_REGION = 0x10000;
+	constexpr std::uintptr_t SECOND_REGION = 0x100000;
+	constexpr std::size_t REGION_SIZE = 128*1024;
+
+	using Live = std::vector<std::pair<HeapAllocator::Handle, std::size_t>>;
+
+	bool inRegion(std::uintptr_t start, std::uintptr_t end)
+	{
+		return (start >= FIRST_REGION && end <= FIRST_REGION + REGION_SIZE)
+			|| (start >= SECOND_REGION && end <= SECOND_REGION + REGION_SIZE);
+	}
+
+	// what is handed out is aligned, inside the regions, at least as large
+	// as asked for and never overlaps. the statistics agree
+	void checkLive(const HeapAllocator& allocator, const Live& live)
+	{
+		std::vector<std::pair<std::uintptr_t, std::uintptr_t>> ranges;
+		std::size_t used = 0;
+		auto wrong = 0u;
+
+		for (auto& allocation : live)
+		{
+			auto address = allocator.address(allocation.first);
+			auto size = allocator.size(allocation.first);
+
+			wrong += size < allocation.second || address % HeapAllocator::GRANULARITY || !inRegion(address, address + size);
+			ranges.push_back({address, address + size});
+			used += size;
+		}
+
+		std::sort(ranges.begin(), ranges.end());
+		auto overlaps = 0u;
+
+		for (auto i = 1u; i < ranges.size(); ++i)
+		{
+			overlaps += ranges[i].first < ranges[i-1].second;
+		}
+
+		auto statistics = allocator.statistics();
+
+		CHECK(wrong == 0);
+		CHECK(overlaps == 0);
+		CHECK(statistics.usedBytes == used);
+		CHECK(statistics.allocations == live.size());
+		CHECK(statistics.freeBytes == statistics.totalBytes - used);
+	}
+} // anonymous namespace
+
+int main(void)
+{
+	HeapAllocator allocator;
+	allocator.addRegion(FIRST_REGION, REGION_SIZE);
+	allocator.addRegion(SECOND_REGION, REGION_SIZE);
+
+	// vertex and index buffers of everything on screen, made and dropped
+	// in no particular order
+	Live live;
+	auto seed = 1u;
+	auto failures = 0u;
+
+	for (auto i = 0u; i < 200000; ++i)
+	{
+		seed = seed*1103515245 + 12345;
+
+		if (live.empty() || (seed >> 16)%100 < 55)
+		{
+			seed = seed*1103515245 + 12345;
+			auto size = 1 + (seed >> 16)%(i%4 ? 200 : 4000);
+			auto handle = allocator.allocate(size);
+
+			if (handle == HeapAllocator::INVALID_HANDLE)
+			{
+				++failures;
+				continue;
+			}
+
+			live.push_back({handle, size});
+		}
+		else
+		{
+			auto index = (seed >> 16)%live.size();
+			allocator.free(live[index].first);
+			live[index] = live.back();
+			live.pop_back();
+		}
+
+		if (i%20000 == 0)
+		{
+			checkLive(allocator, live);
+		}
+	}
+
+	checkLive(allocator, live);
+
+	// this much churn in this little space leaves holes
+	CHECK(allocator.statistics().fragmentation > 0.f);
+
+	for (auto& allocation : live)
+	{
+		allocator.free(allocation.first);
+	}
+
+	// freeing everything merges each region back into one block
+	auto statistics = allocator.statistics();
+
+	CHECK(statistics.usedBytes == 0);
+	CHECK(statistics.allocations == 0);
+	CHECK(statistics.freeBlocks == 2);
+	CHECK(statistics.largestFreeBlock == REGION_SIZE);
+	CHECK(statistics.fragmentation == 0.5f);
+
+	// a block exactly the size asked for is found, even though it is on the
+	// list the size falls on rather than one above
+	auto whole = allocator.allocate(REGION_SIZE);
+	auto second = allocator.allocate(REGION_SIZE);
+
+	CHECK(whole != HeapAllocator::INVALID_HANDLE);
+	CHECK(second != HeapAllocator::INVALID_HANDLE);
+	CHECK(allocator.allocate(1) == HeapAllocator::INVALID_HANDLE);
+	CHECK(allocator.statistics().freeBlocks == 0);
+
+	allocator.free(whole);
+	allocator.free(second);
+
+	HeapAllocator odd;
+	odd.addRegion(FIRST_REGION, 150000 & ~(HeapAllocator::GRANULARITY-1));
+
+	CHECK(odd.allocate(150000 & ~(HeapAllocator::GRANULARITY-1)) != HeapAllocator::INVALID_HANDLE);
+
+	// allocations larger than a region get one of their own, which must
+	// then be able to hold them. the rest of it is still used
+	auto heap = GpuHeap::instance();
+	auto regions = heap->statistics().regions;
+
+	for (auto size : { 131088u, 150000u, 300000u, 1000000u })
+	{
+		GpuHeapBlock<char> block(size);
+
+		CHECK(block.address() != nullptr);
+		CHECK(block.size() >= size);
+
+		std::memset(block.address(), 0xff, size);
+
+		GpuHeapBlock<char> small(64);
+		CHECK(small.address() != nullptr);
+	}
+
+	CHECK(heap->statistics().regions > regions);
+	CHECK(heap->statistics().allocations == 0);
+
+	return Test::result();
+}
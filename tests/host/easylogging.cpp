@@ -0,0 +1,12 @@
+/*
+ * easylogging.cpp - logger storage for the host builds
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <easyloggingpp/easylogging++.h>
+
+INITIALIZE_EASYLOGGINGPP
@@ -0,0 +1,218 @@
+/*
+ * gxm.h - host stand-in for the vitasdk header of the same name
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef HOST_PSP2_GXM_H
+#define HOST_PSP2_GXM_H
+
+#include <psp2/types.h>
+
+// only what the code built for the host uses. values are the sdk's where
+// anything could depend on them, nothing here talks to a gpu
+
+typedef unsigned int SceGxmMemoryAttribFlags;
+
+enum : unsigned int
+{
+	SCE_GXM_MEMORY_ATTRIB_READ = 1,
+	SCE_GXM_MEMORY_ATTRIB_WRITE = 2,
+	SCE_GXM_MEMORY_ATTRIB_RW = 3
+};
+
+enum SceGxmTextureFormat : unsigned int
+{
+	SCE_GXM_TEXTURE_FORMAT_U8_R111 = 0x00001000,
+	SCE_GXM_TEXTURE_FORMAT_A8R8G8B8 = 0x0C000000,
+	SCE_GXM_TEXTURE_FORMAT_UBC1_ABGR = 0x85000000,
+	SCE_GXM_TEXTURE_FORMAT_UBC3_ABGR = 0x87000000
+};
+
+enum SceGxmTextureAddrMode : unsigned int
+{
+	SCE_GXM_TEXTURE_ADDR_REPEAT = 0,
+	SCE_GXM_TEXTURE_ADDR_MIRROR = 1,
+	SCE_GXM_TEXTURE_ADDR_CLAMP = 2,
+	SCE_GXM_TEXTURE_ADDR_MIRROR_CLAMP = 3,
+	SCE_GXM_TEXTURE_ADDR_REPEAT_IGNORE_BORDER = 4,
+	SCE_GXM_TEXTURE_ADDR_CLAMP_FULL_BORDER = 5,
+	SCE_GXM_TEXTURE_ADDR_CLAMP_IGNORE_BORDER = 6,
+	SCE_GXM_TEXTURE_ADDR_CLAMP_HALF_BORDER = 7
+};
+
+enum SceGxmTextureFilter : unsigned int
+{
+	SCE_GXM_TEXTURE_FILTER_POINT = 0,
+	SCE_GXM_TEXTURE_FILTER_LINEAR = 1
+};
+
+enum SceGxmTextureMipFilter : unsigned int
+{
+	SCE_GXM_TEXTURE_MIP_FILTER_DISABLED = 0,
+	SCE_GXM_TEXTURE_MIP_FILTER_ENABLED = 1
+};
+
+struct SceGxmContext;
+
+struct SceGxmTexture
+{
+	unsigned int controlWords[4];
+};
+
+enum SceGxmProgramType : unsigned int
+{
+	SCE_GXM_VERTEX_PROGRAM = 0,
+	SCE_GXM_FRAGMENT_PROGRAM = 1
+};
+
+enum SceGxmParameterCategory : unsigned int
+{
+	SCE_GXM_PARAMETER_CATEGORY_ATTRIBUTE = 0,
+	SCE_GXM_PARAMETER_CATEGORY_UNIFORM = 1
+};
+
+enum SceGxmAttributeFormat : unsigned int
+{
+	SCE_GXM_ATTRIBUTE_FORMAT_U8 = 0,
+	SCE_GXM_ATTRIBUTE_FORMAT_S8 = 1,
+	SCE_GXM_ATTRIBUTE_FORMAT_U16 = 2,
+	SCE_GXM_ATTRIBUTE_FORMAT_S16 = 3,
+	SCE_GXM_ATTRIBUTE_FORMAT_U8N = 4,
+	SCE_GXM_ATTRIBUTE_FORMAT_S8N = 5,
+	SCE_GXM_ATTRIBUTE_FORMAT_U16N = 6,
+	SCE_GXM_ATTRIBUTE_FORMAT_S16N = 7,
+	SCE_GXM_ATTRIBUTE_FORMAT_F16 = 8,
+	SCE_GXM_ATTRIBUTE_FORMAT_F32 = 9
+};
+
+enum SceGxmIndexSource : unsigned int
+{
+	SCE_GXM_INDEX_SOURCE_INDEX_16BIT = 0x00000000
+};
+
+enum SceGxmPrimitiveType : unsigned int
+{
+	SCE_GXM_PRIMITIVE_TRIANGLES = 0x00000000,
+	SCE_GXM_PRIMITIVE_TRIANGLE_FAN = 0x10000000
+};
+
+enum SceGxmIndexFormat : unsigned int
+{
+	SCE_GXM_INDEX_FORMAT_U16 = 0x00000000
+};
+
+enum SceGxmOutputRegisterFormat : unsigned int
+{
+	SCE_GXM_OUTPUT_REGISTER_FORMAT_UCHAR4 = 0x00000000
+};
+
+enum SceGxmMultisampleMode : unsigned int
+{
+	SCE_GXM_MULTISAMPLE_NONE = 0
+};
+
+struct SceGxmProgram;
+struct SceGxmProgramParameter;
+struct SceGxmShaderPatcher;
+struct SceGxmRegisteredProgram;
+struct SceGxmVertexProgram;
+struct SceGxmFragmentProgram;
+struct SceGxmBlendInfo;
+
+typedef SceGxmRegisteredProgram *SceGxmShaderPatcherId;
+
+struct SceGxmVertexAttribute
+{
+	unsigned short streamIndex;
+	unsigned short offset;
+	unsigned char format;
+	unsigned char componentCount;
+	unsigned short regIndex;
+};
+
+struct SceGxmVertexStream
+{
+	unsigned short stride;
+	unsigned short indexSource;
+};
+
+struct SceGxmNotification
+{
+	volatile unsigned int *address;
+	unsigned int value;
+};
+
+typedef void *(*SceGxmShaderPatcherHostAllocCallback)(void *userData, unsigned int size);
+typedef void (*SceGxmShaderPatcherHostFreeCallback)(void *userData, void *mem);
+typedef void *(*SceGxmShaderPatcherBufferAllocCallback)(void *userData, unsigned int size);
+typedef void (*SceGxmShaderPatcherBufferFreeCallback)(void *userData, void *mem);
+typedef void *(*SceGxmShaderPatcherUsseAllocCallback)(void *userData, unsigned int size, unsigned int *usseOffset);
+typedef void (*SceGxmShaderPatcherUsseFreeCallback)(void *userData, void *mem);
+
+struct SceGxmShaderPatcherParams
+{
+	void *userData;
+	SceGxmShaderPatcherHostAllocCallback hostAllocCallback;
+	SceGxmShaderPatcherHostFreeCallback hostFreeCallback;
+	SceGxmShaderPatcherBufferAllocCallback bufferAllocCallback;
+	SceGxmShaderPatcherBufferFreeCallback bufferFreeCallback;
+	void *bufferMem;
+	unsigned int bufferMemSize;
+	SceGxmShaderPatcherUsseAllocCallback vertexUsseAllocCallback;
+	SceGxmShaderPatcherUsseFreeCallback vertexUsseFreeCallback;
+	void *vertexUsseMem;
+	unsigned int vertexUsseMemSize;
+	unsigned int vertexUsseOffset;
+	SceGxmShaderPatcherUsseAllocCallback fragmentUsseAllocCallback;
+	SceGxmShaderPatcherUsseFreeCallback fragmentUsseFreeCallback;
+	void *fragmentUsseMem;
+	unsigned int fragmentUsseMemSize;
+	unsigned int fragmentUsseOffset;
+};
+
+int sceGxmMapMemory(void *base, SceSize size, SceGxmMemoryAttribFlags attr);
+int sceGxmUnmapMemory(void *base);
+int sceGxmMapVertexUsseMemory(void *base, SceSize size, unsigned int *offset);
+int sceGxmUnmapVertexUsseMemory(void *base);
+int sceGxmMapFragmentUsseMemory(void *base, SceSize size, unsigned int *offset);
+int sceGxmUnmapFragmentUsseMemory(void *base);
+
+int sceGxmTextureInitLinear(SceGxmTexture *texture, const void *data, SceGxmTextureFormat texFormat, unsigned int width, unsigned int height, unsigned int mipCount);
+int sceGxmTextureInitSwizzled(SceGxmTexture *texture, const void *data, SceGxmTextureFormat texFormat, unsigned int width, unsigned int height, unsigned int mipCount);
+int sceGxmTextureSetMinFilter(SceGxmTexture *texture, SceGxmTextureFilter minFilter);
+int sceGxmTextureSetMagFilter(SceGxmTexture *texture, SceGxmTextureFilter magFilter);
+int sceGxmTextureSetUAddrMode(SceGxmTexture *texture, SceGxmTextureAddrMode mode);
+int sceGxmTextureSetVAddrMode(SceGxmTexture *texture, SceGxmTextureAddrMode mode);
+int sceGxmSetFragmentTexture(SceGxmContext *context, unsigned int textureIndex, const SceGxmTexture *texture);
+
+int sceGxmProgramCheck(const SceGxmProgram *program);
+SceGxmProgramType sceGxmProgramGetType(const SceGxmProgram *program);
+const SceGxmProgramParameter *sceGxmProgramFindParameterByName(const SceGxmProgram *program, const char *name);
+SceGxmParameterCategory sceGxmProgramParameterGetCategory(const SceGxmProgramParameter *parameter);
+unsigned int sceGxmProgramParameterGetResourceIndex(const SceGxmProgramParameter *parameter);
+int sceGxmSetUniformDataF(void *uniformBuffer, const SceGxmProgramParameter *parameter, unsigned int componentOffset, unsigned int componentCount, const float *sourceData);
+
+int sceGxmShaderPatcherCreate(const SceGxmShaderPatcherParams *params, SceGxmShaderPatcher **shaderPatcher);
+int sceGxmShaderPatcherDestroy(SceGxmShaderPatcher *shaderPatcher);
+int sceGxmShaderPatcherRegisterProgram(SceGxmShaderPatcher *shaderPatcher, const SceGxmProgram *programHeader, SceGxmShaderPatcherId *programId);
+int sceGxmShaderPatcherUnregisterProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmShaderPatcherId programId);
+const SceGxmProgram *sceGxmShaderPatcherGetProgramFromId(SceGxmShaderPatcherId programId);
+int sceGxmShaderPatcherCreateVertexProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmShaderPatcherId programId, const SceGxmVertexAttribute *attributes, unsigned int attributeCount, const SceGxmVertexStream *streams, unsigned int streamCount, SceGxmVertexProgram **vertexProgram);
+int sceGxmShaderPatcherCreateFragmentProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmShaderPatcherId programId, SceGxmOutputRegisterFormat outputFormat, SceGxmMultisampleMode multisampleMode, const SceGxmBlendInfo *blendInfo, const SceGxmProgram *vertexProgram, SceGxmFragmentProgram **fragmentProgram);
+int sceGxmShaderPatcherReleaseVertexProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmVertexProgram *vertexProgram);
+int sceGxmShaderPatcherReleaseFragmentProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmFragmentProgram *fragmentProgram);
+
+int sceGxmReserveVertexDefaultUniformBuffer(SceGxmContext *context, void **uniformBuffer);
+void sceGxmSetVertexProgram(SceGxmContext *context, const SceGxmVertexProgram *vertexProgram);
+void sceGxmSetFragmentProgram(SceGxmContext *context, const SceGxmFragmentProgram *fragmentProgram);
+int sceGxmSetVertexStream(SceGxmContext *context, unsigned int streamIndex, const void *streamData);
+int sceGxmDraw(SceGxmContext *context, SceGxmPrimitiveType primType, SceGxmIndexFormat indexType, const void *indexData, unsigned int indexCount);
+
+volatile unsigned int *sceGxmGetNotificationRegion(void);
+int sceGxmNotificationWait(const SceGxmNotification *notification);
+
+#endif // HOST_PSP2_GXM_H
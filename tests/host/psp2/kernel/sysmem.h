@@ -0,0 +1,36 @@
+/*
+ * sysmem.h - host stand-in for the vitasdk header of the same name
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef HOST_PSP2_KERNEL_SYSMEM_H
+#define HOST_PSP2_KERNEL_SYSMEM_H
+
+#include <psp2/types.h>
+
+enum SceKernelMemBlockType : unsigned int
+{
+	SCE_KERNEL_MEMBLOCK_TYPE_USER_RW_UNCACHE = 0x0C208060,
+	SCE_KERNEL_MEMBLOCK_TYPE_USER_RW = 0x0C20D060,
+	SCE_KERNEL_MEMBLOCK_TYPE_USER_MAIN_PHYCONT_RW = 0x0C80D060,
+	SCE_KERNEL_MEMBLOCK_TYPE_USER_MAIN_PHYCONT_NC_RW = 0x0D808060,
+	SCE_KERNEL_MEMBLOCK_TYPE_USER_CDRAM_RW = 0x09408060
+};
+
+struct SceKernelAllocMemBlockOpt
+{
+	SceSize size;
+	unsigned int attr;
+	SceSize alignment;
+	unsigned int reserved[7];
+};
+
+SceUID sceKernelAllocMemBlock(const char *name, SceKernelMemBlockType type, int size, SceKernelAllocMemBlockOpt *optp);
+int sceKernelGetMemBlockBase(SceUID uid, void **basep);
+int sceKernelFreeMemBlock(SceUID uid);
+
+#endif // HOST_PSP2_KERNEL_SYSMEM_H
@@ -0,0 +1,18 @@
+/*
+ * types.h - host stand-in for the vitasdk header of the same name
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef HOST_PSP2_TYPES_H
+#define HOST_PSP2_TYPES_H
+
+#include <cstddef>
+
+typedef int SceUID;
+typedef unsigned int SceSize;
+
+#endif // HOST_PSP2_TYPES_H
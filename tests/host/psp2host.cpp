@@ -0,0 +1,140 @@
+/*
+ * psp2host.cpp - host implementations of the vita functions under test
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "psp2host.h"
+
+#include <psp2/kernel/sysmem.h>
+#include <psp2/gxm.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+	// memory blocks come from the c heap. they are zeroed like fresh pages
+	// and page aligned, which the gpu heap relies on
+	constexpr std::size_t PAGE_SIZE = 4*1024;
+
+	std::mutex g_blockMutex;
+	std::unordered_map<SceUID, void *> g_blocks;
+	SceUID g_nextBlock = 1;
+
+	Host::DrawCall g_lastDraw{};
+}
+
+Host::DrawCall Host::lastDraw(void)
+{
+	return g_lastDraw;
+}
+
+SceUID sceKernelAllocMemBlock(const char *name, SceKernelMemBlockType type, int size, SceKernelAllocMemBlockOpt *optp)
+{
+	auto address = std::aligned_alloc(PAGE_SIZE, (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+
+	if (!address)
+		return -1;
+
+	std::memset(address, 0, size);
+
+	std::lock_guard<std::mutex> lock(g_blockMutex);
+	g_blocks[g_nextBlock] = address;
+	return g_nextBlock++;
+}
+
+int sceKernelGetMemBlockBase(SceUID uid, void **basep)
+{
+	std::lock_guard<std::mutex> lock(g_blockMutex);
+	auto it = g_blocks.find(uid);
+
+	if (it == g_blocks.end())
+		return -1;
+
+	*basep = it->second;
+	return 0;
+}
+
+int sceKernelFreeMemBlock(SceUID uid)
+{
+	std::lock_guard<std::mutex> lock(g_blockMutex);
+	auto it = g_blocks.find(uid);
+
+	if (it == g_blocks.end())
+		return -1;
+
+	std::free(it->second);
+	g_blocks.erase(it);
+	return 0;
+}
+
+// mapping is only bookkeeping for the gpu
+int sceGxmMapMemory(void *base, SceSize size, SceGxmMemoryAttribFlags attr) { return 0; }
+int sceGxmUnmapMemory(void *base) { return 0; }
+int sceGxmMapVertexUsseMemory(void *base, SceSize size, unsigned int *offset) { *offset = 0; return 0; }
+int sceGxmUnmapVertexUsseMemory(void *base) { return 0; }
+int sceGxmMapFragmentUsseMemory(void *base, SceSize size, unsigned int *offset) { *offset = 0; return 0; }
+int sceGxmUnmapFragmentUsseMemory(void *base) { return 0; }
+
+// textures keep nothing but what they were set up with
+int sceGxmTextureInitLinear(SceGxmTexture *texture, const void *data, SceGxmTextureFormat texFormat, unsigned int width, unsigned int height, unsigned int mipCount) { return 0; }
+int sceGxmTextureInitSwizzled(SceGxmTexture *texture, const void *data, SceGxmTextureFormat texFormat, unsigned int width, unsigned int height, unsigned int mipCount) { return 0; }
+int sceGxmTextureSetMinFilter(SceGxmTexture *texture, SceGxmTextureFilter minFilter) { return 0; }
+int sceGxmTextureSetMagFilter(SceGxmTexture *texture, SceGxmTextureFilter magFilter) { return 0; }
+int sceGxmTextureSetUAddrMode(SceGxmTexture *texture, SceGxmTextureAddrMode mode) { return 0; }
+int sceGxmTextureSetVAddrMode(SceGxmTexture *texture, SceGxmTextureAddrMode mode) { return 0; }
+int sceGxmSetFragmentTexture(SceGxmContext *context, unsigned int textureIndex, const SceGxmTexture *texture) { return 0; }
+
+// nothing is drawn, programs and the patcher are only handles
+int sceGxmProgramCheck(const SceGxmProgram *program) { return 0; }
+SceGxmProgramType sceGxmProgramGetType(const SceGxmProgram *program) { return SCE_GXM_VERTEX_PROGRAM; }
+const SceGxmProgramParameter *sceGxmProgramFindParameterByName(const SceGxmProgram *program, const char *name) { return nullptr; }
+SceGxmParameterCategory sceGxmProgramParameterGetCategory(const SceGxmProgramParameter *parameter) { return SCE_GXM_PARAMETER_CATEGORY_UNIFORM; }
+unsigned int sceGxmProgramParameterGetResourceIndex(const SceGxmProgramParameter *parameter) { return 0; }
+int sceGxmSetUniformDataF(void *uniformBuffer, const SceGxmProgramParameter *parameter, unsigned int componentOffset, unsigned int componentCount, const float *sourceData) { return 0; }
+
+int sceGxmShaderPatcherCreate(const SceGxmShaderPatcherParams *params, SceGxmShaderPatcher **shaderPatcher) { *shaderPatcher = nullptr; return 0; }
+int sceGxmShaderPatcherDestroy(SceGxmShaderPatcher *shaderPatcher) { return 0; }
+int sceGxmShaderPatcherRegisterProgram(SceGxmShaderPatcher *shaderPatcher, const SceGxmProgram *programHeader, SceGxmShaderPatcherId *programId) { *programId = nullptr; return 0; }
+int sceGxmShaderPatcherUnregisterProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmShaderPatcherId programId) { return 0; }
+const SceGxmProgram *sceGxmShaderPatcherGetProgramFromId(SceGxmShaderPatcherId programId) { return nullptr; }
+int sceGxmShaderPatcherCreateVertexProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmShaderPatcherId programId, const SceGxmVertexAttribute *attributes, unsigned int attributeCount, const SceGxmVertexStream *streams, unsigned int streamCount, SceGxmVertexProgram **vertexProgram) { *vertexProgram = nullptr; return 0; }
+int sceGxmShaderPatcherCreateFragmentProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmShaderPatcherId programId, SceGxmOutputRegisterFormat outputFormat, SceGxmMultisampleMode multisampleMode, const SceGxmBlendInfo *blendInfo, const SceGxmProgram *vertexProgram, SceGxmFragmentProgram **fragmentProgram) { *fragmentProgram = nullptr; return 0; }
+int sceGxmShaderPatcherReleaseVertexProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmVertexProgram *vertexProgram) { return 0; }
+int sceGxmShaderPatcherReleaseFragmentProgram(SceGxmShaderPatcher *shaderPatcher, SceGxmFragmentProgram *fragmentProgram) { return 0; }
+
+int sceGxmReserveVertexDefaultUniformBuffer(SceGxmContext *context, void **uniformBuffer)
+{
+	static float buffer[64];
+	*uniformBuffer = buffer;
+	return 0;
+}
+
+void sceGxmSetVertexProgram(SceGxmContext *context, const SceGxmVertexProgram *vertexProgram) {}
+void sceGxmSetFragmentProgram(SceGxmContext *context, const SceGxmFragmentProgram *fragmentProgram) {}
+int sceGxmSetVertexStream(SceGxmContext *context, unsigned int streamIndex, const void *streamData) { return 0; }
+int sceGxmDraw(SceGxmContext *context, SceGxmPrimitiveType primType, SceGxmIndexFormat indexType, const void *indexData, unsigned int indexCount)
+{
+	g_lastDraw = Host::DrawCall{primType, indexType, indexData, indexCount};
+	return 0;
+}
+
+volatile unsigned int *sceGxmGetNotificationRegion(void)
+{
+	static volatile unsigned int region[512];
+	return region;
+}
+
+// there is no gpu to wait for, every frame is done as soon as it is asked
+// about
+int sceGxmNotificationWait(const SceGxmNotification *notification)
+{
+	*notification->address = notification->value;
+	return 0;
+}
@@ -0,0 +1,29 @@
+/*
+ * psp2host.h - what the host vita functions were last asked to do
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef PSP2HOST_H
+#define PSP2HOST_H
+
+#include <psp2/gxm.h>
+
+namespace Host
+{
+	struct DrawCall
+	{
+		SceGxmPrimitiveType primitive;
+		SceGxmIndexFormat indexFormat;
+		const void *indices;
+		unsigned int indexCount;
+	};
+
+	// sceGxmDraw draws nothing, it only remembers the call
+	DrawCall lastDraw(void);
+}
+
+#endif // PSP2HOST_H
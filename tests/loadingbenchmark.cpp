@@ -0,0 +1,115 @@
+/*
+ * loadingbenchmark.cpp - page set asset loading, serial against parallel
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <font.h>
+#include <resource.h>
+#include <texturecache.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// what InstallerView's constructor loads: the background layers, the
+	// checkbox images, two or three fonts for each of the nine pages, and
+	// the shader programs
+	std::vector<std::string> textureFiles(const std::string& extension, const std::string& checkboxPrefix)
+	{
+		return
+		{
+			"app0:/textures/bgbase" + extension,
+			"app0:/textures/bgspec1" + extension,
+			"app0:/textures/bgspec2" + extension,
+			"app0:/textures/bgspec3" + extension,
+			"app0:/textures/bgspec4" + extension,
+			checkboxPrefix + "textures/checkbox-checked" + extension,
+			checkboxPrefix + "textures/checkbox-unchecked" + extension
+		};
+	}
+
+	const ResourceFactory::Name shaders[] =
+	{
+		"rsc:/animbg.vert.cg.gxp"_rsc, "rsc:/animbg.frag.cg.gxp"_rsc,
+		"rsc:/compactcolour.vert.cg.gxp"_rsc, "rsc:/colour.frag.cg.gxp"_rsc,
+		"rsc:/text.vert.cg.gxp"_rsc, "rsc:/sdftext.frag.cg.gxp"_rsc,
+		"rsc:/compacttexture.vert.cg.gxp"_rsc, "rsc:/text.frag.cg.gxp"_rsc,
+		"rsc:/backgroundtext.vert.cg.gxp"_rsc, "rsc:/backgroundtext.frag.cg.gxp"_rsc
+	};
+
+	const float pageFontSizes[] = { 20.f, 12.f, 18.f, 16.f, 8.f, 20.f, 12.f, 8.f, 20.f, 10.f, 8.f, 20.f, 12.f, 8.f, 20.f, 12.f, 8.f, 20.f, 12.f, 20.f, 12.f, 20.f, 12.f };
+
+	struct PageSet
+	{
+		std::vector<TextureCache::TexturePtr> textures;
+		std::vector<Resource::View> shaders;
+		std::vector<std::unique_ptr<Font>> fonts;
+	};
+
+	void loadShadersAndFonts(PageSet *set)
+	{
+		for (auto shader : shaders)
+		{
+			set->shaders.push_back(Resource::view(shader));
+		}
+
+		for (auto size : pageFontSizes)
+		{
+			auto font = std::make_unique<Font>("rsc:/fonts/DroidSans.ttf");
+			font->setPointSize(size);
+			font->setDistanceField(true);
+			font->glyphInfo('H');
+			set->fonts.push_back(std::move(font));
+		}
+	}
+
+	// each texture waits for the last, as every constructor used to
+	void loadSerial(const std::vector<std::string>& files)
+	{
+		PageSet set;
+
+		for (auto& file : files)
+		{
+			set.textures.push_back(TextureCache::instance()->texture(file));
+		}
+
+		loadShadersAndFonts(&set);
+	}
+
+	// every decode is queued on the background scheduler before any is
+	// waited for, and the synchronous loads happen in the meantime
+	void loadParallel(const std::vector<std::string>& files)
+	{
+		PageSet set;
+		set.textures = TextureCache::instance()->textures(files);
+		loadShadersAndFonts(&set);
+	}
+}
+
+int main(void)
+{
+	if (!Resource::view("app0:/textures/bgbase.png").good)
+	{
+		std::fprintf(stderr, "run from the build directory, app0:/ is read from there\n");
+		return 1;
+	}
+
+	// the caches only hold weak references, so every run starts cold
+	auto png = textureFiles(".png", "app0:/");
+	auto baked = textureFiles(".rtex", "rsc:/");
+
+	Benchmark::report("png page set, serial", Benchmark::measure(2, [&](unsigned int) { loadSerial(png); }));
+	Benchmark::report("png page set, parallel", Benchmark::measure(2, [&](unsigned int) { loadParallel(png); }));
+	Benchmark::report("baked page set, serial", Benchmark::measure(2, [&](unsigned int) { loadSerial(baked); }));
+	Benchmark::report("baked page set, parallel", Benchmark::measure(2, [&](unsigned int) { loadParallel(baked); }));
+	return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * quadindexbuffertest.cpp - the shared quad indices and their draws
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/quadindexbuffer.h>
+
+#include <host/psp2host.h>
+
+#include "test.h"
+
+int main(void)
+{
+	auto buffer = QuadIndexBuffer::instance();
+	auto indices = buffer->indices();
+
+	// the last quad's top right is the last vertex 16 bit indices reach
+	CHECK(QuadIndexBuffer::MAX_QUADS == 16384);
+	CHECK(QuadIndexBuffer::INDICES_PER_QUAD == 6);
+
+	// two triangles a quad, bottom left, bottom right, top left and then
+	// bottom right, top right, top left, both wound the same way
+	const uint16_t pattern[] = { 0, 1, 2, 1, 3, 2 };
+	auto wrong = 0u;
+
+	for (auto quad = 0u; quad < QuadIndexBuffer::MAX_QUADS; ++quad)
+	{
+		for (auto i = 0u; i < QuadIndexBuffer::INDICES_PER_QUAD; ++i)
+		{
+			wrong += indices[quad*QuadIndexBuffer::INDICES_PER_QUAD + i] != quad*4 + pattern[i];
+		}
+	}
+
+	CHECK(wrong == 0);
+	CHECK(indices[QuadIndexBuffer::MAX_QUADS*QuadIndexBuffer::INDICES_PER_QUAD - 2] == 65535);
+
+	// a run of quads is one draw of its triangles, starting at its first
+	// quad's indices
+	buffer->draw(nullptr, 0, 1);
+
+	auto draw = Host::lastDraw();
+
+	CHECK(draw.primitive == SCE_GXM_PRIMITIVE_TRIANGLES);
+	CHECK(draw.indexFormat == SCE_GXM_INDEX_FORMAT_U16);
+	CHECK(draw.indices == indices);
+	CHECK(draw.indexCount == 6);
+
+	buffer->draw(nullptr, 10, 7);
+	draw = Host::lastDraw();
+
+	CHECK(draw.indices == indices + 60);
+	CHECK(draw.indexCount == 42);
+
+	// up to the very last quad
+	buffer->draw(nullptr, QuadIndexBuffer::MAX_QUADS-3, 3);
+	draw = Host::lastDraw();
+
+	CHECK(draw.indices == indices + (QuadIndexBuffer::MAX_QUADS-3)*6);
+	CHECK(draw.indexCount == 18);
+
+	return Test::result();
+}
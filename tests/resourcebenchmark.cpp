@@ -0,0 +1,115 @@
+/*
+ * resourcebenchmark.cpp - resource table lookups against the old map
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <resource.h>
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// every embedded resource the installer asks for
+	const char *names[] =
+	{
+		"cube.vert.cg.gxp", "clear.vert.cg.gxp", "animbg.vert.cg.gxp",
+		"text.vert.cg.gxp", "colour.vert.cg.gxp", "backgroundtext.vert.cg.gxp",
+		"texture.vert.cg.gxp", "compactcolour.vert.cg.gxp", "compacttexture.vert.cg.gxp",
+		"cube.frag.cg.gxp", "clear.frag.cg.gxp", "animbg.frag.cg.gxp",
+		"text.frag.cg.gxp", "colour.frag.cg.gxp", "backgroundtext.frag.cg.gxp",
+		"sdftext.frag.cg.gxp", "fonts/DroidSans.ttf", "fonts/DroidSans.glyphs",
+		"textures/checkbox-checked.rtex", "textures/checkbox-unchecked.rtex"
+	};
+
+	constexpr auto NAME_COUNT = sizeof(names)/sizeof(names[0]);
+
+	// what resource2cpp.py used to generate: a map filled before main
+	using ResourceMap = std::unordered_map<std::string, ResourceFactory::Resource>;
+
+	ResourceMap buildMap(void)
+	{
+		ResourceMap map;
+
+		for (auto name : names)
+		{
+			auto path = std::string("rsc:/") + name;
+			map.insert({ path, *ResourceFactory::find(path) });
+		}
+
+		return map;
+	}
+}
+
+int main(void)
+{
+	const unsigned int ITERATIONS = 1000000;
+
+	// the table has nothing to build, it is constant initialised
+	Benchmark::report("static init: unordered_map (whole table)", Benchmark::measure(10000, [](unsigned int)
+	{
+		auto map = buildMap();
+		Benchmark::keep(map);
+	}));
+
+	Benchmark::report("static init: constexpr table", 0.0);
+
+	auto map = buildMap();
+	std::vector<std::string> files(names, names + NAME_COUNT);
+	std::vector<std::string> paths;
+
+	for (auto name : names)
+	{
+		paths.push_back(std::string("rsc:/") + name);
+	}
+
+	// Resource::read used to strip the prefix and build the key again
+	Benchmark::report("lookup: unordered_map, key concatenated", Benchmark::measure(ITERATIONS, [&](unsigned int i)
+	{
+		auto it = map.find("rsc:/" + files[i % NAME_COUNT]);
+		Benchmark::keep(it);
+	}));
+
+	Benchmark::report("lookup: unordered_map, std::string key", Benchmark::measure(ITERATIONS, [&](unsigned int i)
+	{
+		auto it = map.find(paths[i % NAME_COUNT]);
+		Benchmark::keep(it);
+	}));
+
+	Benchmark::report("lookup: perfect hash, std::string key", Benchmark::measure(ITERATIONS, [&](unsigned int i)
+	{
+		auto res = ResourceFactory::find(paths[i % NAME_COUNT]);
+		Benchmark::keep(res);
+	}));
+
+	// the literal is hashed by the compiler, only the slot and name are checked
+	const ResourceFactory::Name literals[] =
+	{
+		"rsc:/text.vert.cg.gxp"_rsc,
+		"rsc:/sdftext.frag.cg.gxp"_rsc,
+		"rsc:/compactcolour.vert.cg.gxp"_rsc,
+		"rsc:/colour.frag.cg.gxp"_rsc
+	};
+
+	Benchmark::report("lookup: perfect hash, _rsc literal", Benchmark::measure(ITERATIONS, [&](unsigned int i)
+	{
+		auto res = ResourceFactory::find(literals[i % 4]);
+		Benchmark::keep(res);
+	}));
+
+	Benchmark::report("lookup: perfect hash, misses", Benchmark::measure(ITERATIONS, [&](unsigned int i)
+	{
+		auto res = ResourceFactory::find(files[i % NAME_COUNT]);
+		Benchmark::keep(res);
+	}));
+
+	return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * resourcetest.cpp - embedded resource table lookups
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "test.h"
+
+#include <resource.h>
+
+#include <cstring>
+#include <string>
+
+int main(void)
+{
+	const char *names[] =
+	{
+		"rsc:/text.vert.cg.gxp",
+		"rsc:/sdftext.frag.cg.gxp",
+		"rsc:/compacttexture.vert.cg.gxp",
+		"rsc:/fonts/DroidSans.ttf",
+		"rsc:/fonts/DroidSans.glyphs",
+		"rsc:/textures/checkbox-checked.rtex"
+	};
+
+	// the table knows every name whichever way it is asked
+	for (auto name : names)
+	{
+		auto res = ResourceFactory::find(std::string(name));
+
+		CHECK(res != nullptr);
+		CHECK(res && std::strcmp(res->name, name) == 0);
+		CHECK(ResourceFactory::find(name, std::strlen(name)) == res);
+		CHECK(ResourceFactory::contains(ResourceFactory::id(name, std::strlen(name))));
+	}
+
+	// and hashes literals the same as it does at run time
+	constexpr auto literal = "rsc:/text.vert.cg.gxp"_rsc;
+	static_assert(ResourceFactory::contains(literal.id), "literal does not hash like the generated table");
+
+	CHECK(ResourceFactory::find(literal) == ResourceFactory::find(std::string("rsc:/text.vert.cg.gxp")));
+	CHECK(literal.length == std::strlen("rsc:/text.vert.cg.gxp"));
+
+	// names we do not have are refused, as is one that hashes like one we do
+	CHECK(ResourceFactory::find(std::string("rsc:/missing.gxp")) == nullptr);
+	CHECK(ResourceFactory::find("rsc:/missing.gxp"_rsc) == nullptr);
+	CHECK(ResourceFactory::find(std::string("rsc:/text.vert.cg")) == nullptr);
+	CHECK(ResourceFactory::find(ResourceFactory::Name{ "rsc:/missing.gxp", 16, literal.id }) == nullptr);
+
+	// views by literal and by string are the same bytes, in place
+	auto byLiteral = Resource::view("rsc:/fonts/DroidSans.ttf"_rsc);
+	auto byString = Resource::view(std::string("rsc:/fonts/DroidSans.ttf"));
+
+	CHECK(byLiteral.good && byString.good);
+	CHECK(byLiteral.data == byString.data && byLiteral.size == byString.size);
+	CHECK(byLiteral.borrowed());
+	CHECK(!Resource::view("rsc:/missing.gxp"_rsc).good);
+
+	return Test::result();
+}
@@ -0,0 +1,148 @@
+/*
+ * resourceviewbenchmark.cpp - copying embedded resources against viewing them
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <resource.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// every embedded resource the installer asks for
+	const char *names[] =
+	{
+		"rsc:/cube.vert.cg.gxp", "rsc:/clear.vert.cg.gxp", "rsc:/animbg.vert.cg.gxp",
+		"rsc:/text.vert.cg.gxp", "rsc:/colour.vert.cg.gxp", "rsc:/backgroundtext.vert.cg.gxp",
+		"rsc:/texture.vert.cg.gxp", "rsc:/compactcolour.vert.cg.gxp", "rsc:/compacttexture.vert.cg.gxp",
+		"rsc:/cube.frag.cg.gxp", "rsc:/clear.frag.cg.gxp", "rsc:/animbg.frag.cg.gxp",
+		"rsc:/text.frag.cg.gxp", "rsc:/colour.frag.cg.gxp", "rsc:/backgroundtext.frag.cg.gxp",
+		"rsc:/sdftext.frag.cg.gxp", "rsc:/fonts/DroidSans.ttf", "rsc:/fonts/DroidSans.glyphs",
+		"rsc:/textures/checkbox-checked.rtex", "rsc:/textures/checkbox-unchecked.rtex"
+	};
+
+	// every operator new in the process carries its size in front of it, so
+	// the bytes live at once can be followed
+	constexpr std::size_t HEADER = alignof(std::max_align_t);
+
+	std::atomic<std::size_t> g_bytes{0};
+	std::atomic<std::size_t> g_peak{0};
+
+	void resetPeak(void)
+	{
+		g_peak = g_bytes.load();
+	}
+
+	std::size_t peak(void)
+	{
+		return g_peak.load();
+	}
+
+	void report(const char *name, std::size_t bytes)
+	{
+		std::printf("%-48s %12zu bytes peak\n", name, bytes);
+	}
+
+	// what a page does while it starts up: every resource it needs is
+	// held at once
+	template <typename T, typename Load>
+	std::size_t loadSet(Load load)
+	{
+		std::vector<T> set;
+		set.reserve(sizeof(names)/sizeof(names[0]));
+
+		auto baseline = g_bytes.load();
+		resetPeak();
+
+		for (auto name : names)
+		{
+			set.push_back(load(name));
+
+			if (!set.back().good)
+			{
+				std::fprintf(stderr, "missing resource: %s\n", name);
+				std::exit(1);
+			}
+		}
+
+		Benchmark::keep(set);
+		return peak() - baseline;
+	}
+} // anonymous namespace
+
+void *operator new(std::size_t size)
+{
+	if (auto block = static_cast<char *>(std::malloc(size + HEADER)))
+	{
+		*reinterpret_cast<std::size_t *>(block) = size;
+
+		auto bytes = g_bytes += size;
+		auto highest = g_peak.load();
+
+		while (bytes > highest && !g_peak.compare_exchange_weak(highest, bytes))
+		{
+		}
+
+		return block + HEADER;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *address) noexcept
+{
+	if (!address)
+		return;
+
+	auto block = static_cast<char *>(address) - HEADER;
+	g_bytes -= *reinterpret_cast<std::size_t *>(block);
+	std::free(block);
+}
+
+void operator delete(void *address, std::size_t) noexcept
+{
+	operator delete(address);
+}
+
+int main(void)
+{
+	const unsigned int ITERATIONS = 1000;
+
+	auto embedded = 0u;
+
+	for (auto name : names)
+	{
+		embedded += ResourceFactory::find(std::string(name))->rawSize;
+	}
+
+	std::printf("%-48s %12u bytes\n", "embedded set", embedded);
+
+	// read copies every resource in to a vector of its own, a view of a
+	// raw resource points in to the executable. compressed ones are still
+	// inflated in to storage the view shares
+	report("peak: Resource::read (copy)", loadSet<Resource::File>([](const char *name) { return Resource::read(name); }));
+	report("peak: Resource::view", loadSet<Resource::View>([](const char *name) { return Resource::view(name); }));
+
+	Benchmark::report("time: Resource::read (copy), whole set", Benchmark::measure(ITERATIONS, [](unsigned int)
+	{
+		loadSet<Resource::File>([](const char *name) { return Resource::read(name); });
+	}));
+
+	Benchmark::report("time: Resource::view, whole set", Benchmark::measure(ITERATIONS, [](unsigned int)
+	{
+		loadSet<Resource::View>([](const char *name) { return Resource::view(name); });
+	}));
+
+	return 0;
+}
@@ -0,0 +1,320 @@
+/*
+ * ringallocatortest.cpp - per frame gpu memory and what is kept alive with it
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <framework/framering.h>
+#include <framework/gpuheap.h>
+#include <framework/ringallocator.h>
+
+#include <circularsegment.h>
+#include <vertextypes.h>
+
+#include "test.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t RING_SIZE = 64*1024;
+	constexpr unsigned int FRAMES = 3;
+
+	struct Allocation
+	{
+		std::size_t offset;
+		std::size_t size;
+		unsigned long frame;
+	};
+
+	// a frame the gpu has been given but not finished
+	struct InFlight
+	{
+		unsigned long frame;
+		unsigned int slot;
+	};
+
+	bool overlaps(const Allocation& a, std::size_t offset, std::size_t size)
+	{
+		return offset < a.offset + a.size && a.offset < offset + size;
+	}
+
+	// counts how many are alive, to see when the frame ring lets them go
+	struct Released
+	{
+		Released(unsigned int *alive)
+			: m_alive(alive)
+		{
+			++*m_alive;
+		}
+
+		~Released(void)
+		{
+			--*m_alive;
+		}
+
+		unsigned int *m_alive;
+	};
+} // anonymous namespace
+
+int main(void)
+{
+	// a gpu that finishes frames in order, some time after it is given
+	// them. the cpu only waits when it wants a slot still in flight
+	RingAllocator ring(RING_SIZE, FRAMES);
+	std::deque<InFlight> inFlight;
+	std::vector<Allocation> live;
+
+	auto seed = 7u;
+	auto waits = 0u, wraps = 0u, failures = 0u;
+	auto misaligned = 0u, outside = 0u, overlapping = 0u, outOfOrder = 0u;
+	std::size_t last = 0;
+
+	auto finish = [&](void)
+	{
+		auto frame = inFlight.front().frame;
+		inFlight.pop_front();
+
+		for (auto i = 0u; i < live.size();)
+		{
+			if (live[i].frame == frame)
+			{
+				live[i] = live.back();
+				live.pop_back();
+			}
+			else
+			{
+				++i;
+			}
+		}
+	};
+
+	for (auto frame = 0ul; frame < 20000; ++frame)
+	{
+		seed = seed*1103515245 + 12345;
+
+		while (!inFlight.empty() && (seed >> 16)%3 == 0)
+		{
+			ring.retire(inFlight.front().slot);
+			finish();
+			seed = seed*1103515245 + 12345;
+		}
+
+		// the slot about to be reused is always the oldest frame in flight
+		auto next = ring.nextFrame();
+
+		if (ring.pending(next))
+		{
+			outOfOrder += inFlight.front().slot != next;
+			ring.retire(next);
+			finish();
+			++waits;
+		}
+
+		ring.beginFrame();
+
+		seed = seed*1103515245 + 12345;
+		auto count = (seed >> 16)%12;
+
+		for (auto i = 0u; i < count; ++i)
+		{
+			seed = seed*1103515245 + 12345;
+			auto size = 1 + (seed >> 16)%3000;
+			auto alignment = std::size_t(1) << (seed >> 8)%5;
+			auto offset = ring.allocate(size, alignment);
+
+			if (offset == RingAllocator::INVALID_OFFSET)
+			{
+				++failures;
+				continue;
+			}
+
+			misaligned += offset % alignment != 0;
+			outside += offset + size > RING_SIZE;
+			wraps += offset < last;
+			last = offset;
+
+			// nothing the gpu may still read is handed out again
+			for (auto& allocation : live)
+			{
+				overlapping += overlaps(allocation, offset, size);
+			}
+
+			live.push_back({offset, size, frame});
+		}
+
+		ring.endFrame();
+		inFlight.push_back({frame, ring.frame()});
+	}
+
+	CHECK(misaligned == 0);
+	CHECK(outside == 0);
+	CHECK(overlapping == 0);
+	CHECK(outOfOrder == 0);
+	CHECK(inFlight.size() <= FRAMES);
+	CHECK(wraps > 100);
+	CHECK(waits > 0);
+	CHECK(failures == 0);
+	CHECK(ring.statistics().peakFrameBytes < RING_SIZE);
+
+	// a frame larger than the ring is refused rather than overwriting itself
+	RingAllocator small(4096, FRAMES);
+	small.beginFrame();
+
+	CHECK(small.allocate(3000, 16) == 0);
+	CHECK(small.allocate(3000, 16) == RingAllocator::INVALID_OFFSET);
+	CHECK(small.statistics().failures == 1);
+
+	// a frame the gpu has not finished blocks the memory it used, and once
+	// it is retired the next frame starts over at the beginning of the ring
+	small.endFrame();
+	small.beginFrame();
+
+	CHECK(small.allocate(2000, 16) == RingAllocator::INVALID_OFFSET);
+
+	small.endFrame();
+	small.retire(0);
+	small.beginFrame();
+
+	CHECK(small.allocate(3000, 16) == 0);
+
+	// retiring a frame also gives back every frame begun before it, the gpu
+	// finishes them in order
+	RingAllocator ordered(4096, FRAMES);
+
+	for (auto i = 0u; i < FRAMES; ++i)
+	{
+		ordered.beginFrame();
+		ordered.allocate(1024, 16);
+		ordered.endFrame();
+	}
+
+	CHECK(ordered.statistics().usedBytes == 3072);
+
+	ordered.retire(1);
+
+	CHECK(ordered.statistics().usedBytes == 1024);
+	CHECK(!ordered.pending(1));
+	CHECK(ordered.pending(2));
+
+	// an older frame retired late changes nothing
+	ordered.retire(0);
+
+	CHECK(ordered.statistics().usedBytes == 1024);
+
+	ordered.retire(2);
+
+	CHECK(ordered.statistics().usedBytes == 0);
+
+	// something released while drawing a frame lives until that frame's slot
+	// comes round again and its fence has been waited on
+	auto frameRing = FrameRing::instance();
+	auto alive = 0u;
+
+	frameRing->beginFrame();
+	frameRing->release(std::make_unique<Released>(&alive));
+	frameRing->endFrame();
+
+	CHECK(alive == 1);
+
+	for (auto i = 1u; i < FrameRing::FRAMES; ++i)
+	{
+		frameRing->beginFrame();
+		frameRing->endFrame();
+	}
+
+	CHECK(alive == 1);
+
+	frameRing->beginFrame();
+
+	CHECK(alive == 0);
+
+	frameRing->endFrame();
+
+	// and the same between frames, for the frame just submitted
+	frameRing->release(std::make_unique<Released>(&alive));
+
+	for (auto i = 0u; i < FrameRing::FRAMES; ++i)
+	{
+		CHECK(alive == 1);
+		frameRing->beginFrame();
+		frameRing->endFrame();
+	}
+
+	CHECK(alive == 0);
+
+	// waiting for the gpu to go idle finishes every frame given to it, from
+	// between frames or while drawing one
+	frameRing->beginFrame();
+	frameRing->allocate(1024);
+	frameRing->release(std::make_unique<Released>(&alive));
+	frameRing->endFrame();
+
+	frameRing->beginFrame();
+	frameRing->allocate(1024);
+	frameRing->endFrame();
+
+	CHECK(alive == 1);
+	CHECK(frameRing->statistics().usedBytes == 2048);
+
+	frameRing->waitIdle();
+
+	CHECK(alive == 0);
+	CHECK(frameRing->statistics().usedBytes == 0);
+
+	frameRing->beginFrame();
+	frameRing->allocate(1024);
+	frameRing->release(std::make_unique<Released>(&alive));
+	frameRing->waitIdle();
+
+	CHECK(alive == 1);
+	CHECK(frameRing->statistics().usedBytes == 1024);
+
+	frameRing->endFrame();
+	frameRing->waitIdle();
+
+	CHECK(alive == 0);
+
+	// geometry that changes colour while on screen draws from a copy in the
+	// ring each frame. changing it allocates nothing and the copy goes with
+	// the frame
+	CircularSegment<CompactGeometryVertex> segment(10.f, 95.f);
+	auto heap = GpuHeap::instance();
+	auto blocks = heap->statistics().allocations;
+
+	for (auto i = 0u; i < 2*FrameRing::FRAMES; ++i)
+	{
+		frameRing->beginFrame();
+		segment.setColour(glm::vec4(1.f, 0.f, 0.f, i/10.f));
+		segment.draw(nullptr, nullptr, nullptr);
+
+		CHECK(frameRing->statistics().frameBytes >= (segment.steps()+1)*sizeof(CompactGeometryVertex));
+
+		frameRing->endFrame();
+	}
+
+	CHECK(heap->statistics().allocations == blocks);
+
+	// new steps give new indices, the old ones are kept for the frames that
+	// may still use them
+	frameRing->beginFrame();
+	segment.setSteps(100);
+	frameRing->endFrame();
+
+	CHECK(heap->statistics().allocations == blocks + 1);
+
+	for (auto i = 0u; i < FrameRing::FRAMES; ++i)
+	{
+		frameRing->beginFrame();
+		frameRing->endFrame();
+	}
+
+	CHECK(heap->statistics().allocations == blocks);
+
+	return Test::result();
+}
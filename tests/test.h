@@ -0,0 +1,52 @@
+/*
+ * test.h - minimal checks for the host tests
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstdio>
+
+namespace Test
+{
+	inline unsigned int& failures(void)
+	{
+		static unsigned int count = 0;
+		return count;
+	}
+
+	inline bool check(bool condition, const char *expression, const char *file, int line)
+	{
+		if (!condition)
+		{
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+			++failures();
+		}
+
+		return condition;
+	}
+
+	// the exit status for main
+	inline int result(void)
+	{
+		if (failures())
+		{
+			std::fprintf(stderr, "%u checks failed\n", failures());
+			return 1;
+		}
+
+		return 0;
+	}
+}
+
+// carries on after a failure, so one run reports everything that is wrong.
+// easylogging++ has a CHECK of its own that aborts, so include this last
+#undef CHECK
+#define CHECK(condition) Test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // TEST_H
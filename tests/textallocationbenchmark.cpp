@@ -0,0 +1,132 @@
+/*
+ * textallocationbenchmark.cpp - heap allocations made by text that changes
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <font.h>
+#include <text.h>
+
+#include <framework/gpuheap.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace
+{
+	// every operator new in the process is counted. memory blocks are
+	// tracked in a map on the host, so a new gpu block counts too
+	std::atomic<unsigned long> g_allocations{0};
+
+	struct Allocations
+	{
+		unsigned long heap;
+		unsigned int gpuRegions;
+		unsigned int gpuBlocks;
+	};
+
+	Allocations allocations(void)
+	{
+		auto gpu = GpuHeap::instance()->statistics();
+		return Allocations{g_allocations.load(), gpu.regions, gpu.allocations};
+	}
+
+	void report(const char *name, unsigned int calls, const Allocations& before, const Allocations& after)
+	{
+		std::printf("%-40s %8u calls %8lu allocations %6u gpu regions %+6d gpu blocks\n",
+			name,
+			calls,
+			after.heap - before.heap,
+			after.gpuRegions - before.gpuRegions,
+			static_cast<int>(after.gpuBlocks - before.gpuBlocks));
+	}
+
+	// what FpsCounter::update writes every frame
+	void fpsText(char *text, std::size_t size, unsigned int frame)
+	{
+		std::snprintf(text, size, "FPS: %.2f", 30.f + (frame%3000)/100.f);
+	}
+} // anonymous namespace
+
+void *operator new(std::size_t size)
+{
+	++g_allocations;
+
+	if (auto address = std::malloc(size ? size : 1))
+		return address;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *address) noexcept
+{
+	std::free(address);
+}
+
+void operator delete(void *address, std::size_t) noexcept
+{
+	std::free(address);
+}
+
+int main(void)
+{
+	const unsigned int CALLS = 20000;
+
+	Font font("rsc:/fonts/DroidSans.ttf");
+	char text[32];
+
+	// the fps counter: one dynamic text laid out again every frame
+	Text counter(&font, "FPS: 00.00");
+	counter.setDynamic(true);
+
+	// settled once every digit has been seen and the buffers have grown to
+	// the longest string
+	for (auto frame = 0u; frame < 3000; ++frame)
+	{
+		fpsText(text, sizeof(text), frame);
+		counter.setText(text);
+	}
+
+	auto before = allocations();
+
+	auto perCall = Benchmark::measure(CALLS, [&](unsigned int frame)
+	{
+		fpsText(text, sizeof(text), frame);
+		counter.setText(text);
+	});
+
+	report("dynamic Text::setText, fps counter", CALLS*5, before, allocations());
+	Benchmark::report("dynamic Text::setText, fps counter", perCall);
+
+	// a dynamic text moving between strings of different lengths reuses
+	// the buffers it grew for the longest
+	const char *status[] = { "Installing...", "Done", "Installing HENkaku offline enabler", "Reset" };
+
+	Text label(&font, "");
+	label.setDynamic(true);
+
+	for (auto string : status)
+	{
+		label.setText(string);
+	}
+
+	before = allocations();
+
+	Benchmark::measure(CALLS, [&](unsigned int i)
+	{
+		label.setText(status[i%4]);
+	});
+
+	report("dynamic Text::setText, varying lengths", CALLS*5, before, allocations());
+
+	return 0;
+}
@@ -0,0 +1,191 @@
+/*
+ * textbenchmark.cpp - laying out a page of text
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <font.h>
+#include <fontcache.h>
+#include <text.h>
+
+#include <freetype2/ft2build.h>
+#include FT_FREETYPE_H
+
+#include <utf8cpp/utf8.h>
+
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// the text of every page of the installer
+	const char *strings[] =
+	{
+		"Welcome to HENkaku!", "Press right to continue.", "Select an option:",
+		"Simple Installation", "Enables homebrews. Advanced features disabled to protect your device.",
+		"Advanced Installation", "Only for advanced users. Enable potentially dangerous options.",
+		"Configuration", "Enable support for plugins and unsafe homebrew",
+		"Unstable or malicious content can permanently damage your Vita!",
+		"Enable version spoofing to block update prompts",
+		"Spoofing only prevents accidental updates. It won't enable 3.61+ games",
+		"Offline HENkaku", "Would you like to use the HENkaku offline enabler",
+		"from the Email application? Check out", "https://henkaku.xyz/usage for details",
+		"Yes, install offline HENkaku", "Reset", "Would you like to reset all HENkaku and taiHEN data?",
+		"Your games and installed homebrew should", "not be affected.", "Yes, reset my configuration",
+		"Confirm Installation", "You are installing HENkaku with the following options:",
+		"Reset all HENkaku and taiHEN data", "Enable plugins and unsafe homebrew",
+		"Enable version spoofing to prevent updates", "Install HENkaku offline enabler",
+		"Press X to continue.", "FPS: 59.94", "Caf\xc3\xa9 \xc2\xa9 2016"
+	};
+
+	constexpr auto STRING_COUNT = sizeof(strings)/sizeof(strings[0]);
+	constexpr auto FONT_FILE = "rsc:/fonts/DroidSans.ttf";
+	constexpr float POINT_SIZE = 12.f;
+
+	using Pairs = std::vector<std::pair<unsigned int, unsigned int>>;
+
+	// every pair of neighbouring characters on the page, as layout asks
+	// for their kerning
+	Pairs pagePairs(void)
+	{
+		Pairs pairs;
+
+		for (auto string : strings)
+		{
+			std::vector<unsigned int> characters;
+			std::string text(string);
+			utf8::utf8to32(text.begin(), text.end(), std::back_inserter(characters));
+
+			for (auto i = 1u; i < characters.size(); ++i)
+			{
+				pairs.push_back({characters[i], characters[i-1]});
+			}
+		}
+
+		return pairs;
+	}
+
+	// what GlyphStore used to do for every pair: both glyph indices and the
+	// kerning from freetype
+	class FreeTypeKerning
+	{
+	public:
+		FreeTypeKerning(void)
+		{
+			auto data = FontCache::instance()->fontData(FONT_FILE);
+
+			FT_Init_FreeType(&m_library);
+			FT_New_Memory_Face(m_library, reinterpret_cast<const FT_Byte *>(data.data), data.size, 0, &m_face);
+			FT_Set_Char_Size(m_face, 0, FT_F26Dot6(POINT_SIZE*64), 0, 0);
+		}
+
+		~FreeTypeKerning(void)
+		{
+			FT_Done_Face(m_face);
+			FT_Done_FreeType(m_library);
+		}
+
+		glm::vec2 kerningInfo(unsigned int character, unsigned int prev) const
+		{
+			FT_Vector dxy;
+			auto prevIndex = FT_Get_Char_Index(m_face, prev);
+			auto index = FT_Get_Char_Index(m_face, character);
+			FT_Get_Kerning(m_face, prevIndex, index, FT_KERNING_DEFAULT, &dxy);
+			return glm::vec2(dxy.x >> 6, dxy.y >> 6);
+		}
+
+	private:
+		FT_Library m_library;
+		FT_Face m_face;
+	};
+}
+
+int main(void)
+{
+	const unsigned int ITERATIONS = 200;
+
+	Font font(FONT_FILE);
+	font.setPointSize(POINT_SIZE);
+
+	auto pairs = pagePairs();
+	FreeTypeKerning freeType;
+
+	std::printf("%zu strings, %zu kerning pairs, kerning %s\n", STRING_COUNT, pairs.size(), font.kerning() ? "on" : "off");
+
+	// every glyph and pair has been seen before anything is timed
+	for (auto string : strings)
+	{
+		Text(&font, string);
+	}
+
+	auto freeTypePage = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		for (auto& pair : pairs)
+		{
+			auto kerning = freeType.kerningInfo(pair.first, pair.second);
+			Benchmark::keep(kerning);
+		}
+	});
+
+	auto cachedPage = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		for (auto& pair : pairs)
+		{
+			auto kerning = font.kerningInfo(pair.first, pair.second);
+			Benchmark::keep(kerning);
+		}
+	});
+
+	Benchmark::report("kerning pair: freetype (before)", freeTypePage/pairs.size());
+	Benchmark::report("kerning pair: Font::kerningInfo, cached", cachedPage/pairs.size());
+	Benchmark::report("kerning a page: freetype (before)", freeTypePage);
+	Benchmark::report("kerning a page: Font::kerningInfo, cached", cachedPage);
+
+	// a counter lays its text out again on every change
+	Text dynamic;
+	dynamic.setFont(&font);
+	dynamic.setDynamic(true);
+
+	auto layoutPage = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		for (auto string : strings)
+		{
+			dynamic.setText(string);
+		}
+	});
+
+	Benchmark::report("Text::setText a page: dynamic, laid out", layoutPage);
+
+	// the page's kerning is the only part of the layout that changed, so
+	// this is the same page with every pair going to freetype again
+	Benchmark::report("Text::setText a page: dynamic, freetype (before)", layoutPage - cachedPage + freeTypePage);
+
+	// labels showing strings already on screen share their meshes
+	std::vector<std::unique_ptr<Text>> labels;
+
+	for (auto i = 0u; i < STRING_COUNT; ++i)
+	{
+		labels.push_back(std::make_unique<Text>(&font, strings[i]));
+	}
+
+	Text label;
+	label.setFont(&font);
+
+	Benchmark::report("Text::setText a page: static, mesh cache", Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		for (auto string : strings)
+		{
+			label.setText(string);
+		}
+	}));
+
+	return 0;
+}
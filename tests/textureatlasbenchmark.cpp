@@ -0,0 +1,297 @@
+/*
+ * textureatlasbenchmark.cpp - skyline packing speed and occupancy
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <textureatlas.h>
+
+#include <iterator>
+#include <limits>
+#include <list>
+#include <vector>
+
+namespace
+{
+	constexpr int ATLAS_SIZE = 512;
+
+	// glyph sized rectangles, more than fit in the atlas
+	std::vector<glm::uvec2> glyphSizes(std::size_t count, unsigned int seed)
+	{
+		std::vector<glm::uvec2> sizes;
+
+		for (auto i = 0u; i < count; ++i)
+		{
+			seed = seed*1103515245 + 12345;
+			auto width = 2 + (seed >> 16)%30;
+			seed = seed*1103515245 + 12345;
+			auto height = 4 + (seed >> 16)%30;
+			sizes.push_back(glm::uvec2(width, height));
+		}
+
+		return sizes;
+	}
+
+	// the skyline TextureAtlas used to keep: a list walked with iterators
+	// for every fit, and merged from the start after every insert
+	class ListSkyline
+	{
+	public:
+		ListSkyline(void)
+		{
+			clear();
+		}
+
+		void clear(void)
+		{
+			m_nodes.clear();
+			m_nodes.push_back(glm::ivec3(1, 1, ATLAS_SIZE-2));
+		}
+
+		TextureAtlas::AtlasRegion region(std::size_t width, std::size_t height)
+		{
+			constexpr auto max_size = std::numeric_limits<std::size_t>::max();
+			std::size_t best_height = max_size;
+			std::size_t best_width = max_size;
+
+			width += 1;
+			height += 1;
+
+			auto region = TextureAtlas::AtlasRegion(0, 0, width, height);
+			auto best_node = m_nodes.end();
+
+			for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it)
+			{
+				auto y = fit(it, width, height);
+
+				if (y >= 0)
+				{
+					auto node = *it;
+
+					if (((y + height) < best_height)
+						|| (((y + height) == best_height) && (node.z > 0 && static_cast<std::size_t>(node.z) < best_width)))
+					{
+						best_height = y + height;
+						best_width = node.z;
+						best_node = it;
+						region.x = node.x;
+						region.y = y;
+					}
+				}
+			}
+
+			if (best_node == m_nodes.end())
+			{
+				return TextureAtlas::AtlasRegion(-1, -1, 0, 0);
+			}
+
+			m_nodes.insert(best_node, glm::ivec3(region.x, region.y + height, width));
+
+			for (auto it = best_node; it != m_nodes.end();)
+			{
+				auto node = it;
+				auto prev = std::prev(it);
+
+				if (node->x < (prev->x + prev->z))
+				{
+					int shrink = prev->x + prev->z - node->x;
+					node->x += shrink;
+					node->z -= shrink;
+
+					if (node->z <= 0)
+					{
+						it = m_nodes.erase(it);
+					}
+					else
+					{
+						break;
+					}
+				}
+				else
+				{
+					break;
+				}
+			}
+
+			merge();
+			return region;
+		}
+
+	private:
+		using NodeList = std::list<glm::ivec3>;
+
+		int fit(NodeList::iterator it, std::size_t width, std::size_t height)
+		{
+			auto node = *it;
+			auto x = node.x;
+			auto y = node.y;
+			int width_left = width;
+
+			if ((x + width) > ATLAS_SIZE-1)
+			{
+				return -1;
+			}
+
+			while (width_left > 0)
+			{
+				node = *it;
+
+				if (node.y > y)
+				{
+					y = node.y;
+				}
+
+				if ((y + height) > ATLAS_SIZE-1)
+				{
+					return -1;
+				}
+
+				width_left -= node.z;
+				++it;
+			}
+
+			return y;
+		}
+
+		void merge(void)
+		{
+			for (auto it = m_nodes.begin(); it != m_nodes.end();)
+			{
+				auto next = std::next(it);
+
+				if (next == m_nodes.end())
+					return;
+
+				if (it->y == next->y)
+				{
+					it->z += next->z;
+					m_nodes.erase(next);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+	private:
+		NodeList m_nodes;
+	};
+
+	struct Packing
+	{
+		unsigned int placed;
+		std::size_t area;
+	};
+
+	Packing packing(const std::vector<TextureAtlas::AtlasRegion>& regions)
+	{
+		Packing result{0, 0};
+
+		for (auto& region : regions)
+		{
+			if (region.x == -1 || region.y == -1)
+				continue;
+
+			++result.placed;
+			result.area += region.z*region.w;
+		}
+
+		return result;
+	}
+
+	void report(const char *name, double nanoseconds, std::size_t inserts, const Packing& packing)
+	{
+		std::printf("%-36s %10.0f inserts/s %6u placed %6.1f%% occupied\n",
+			name,
+			inserts/(nanoseconds/1e9),
+			packing.placed,
+			100.0*packing.area/(ATLAS_SIZE*ATLAS_SIZE));
+	}
+}
+
+int main(void)
+{
+	const unsigned int ITERATIONS = 20;
+
+	auto sizes = glyphSizes(2000, 1);
+
+	TextureAtlas atlas(ATLAS_SIZE, ATLAS_SIZE);
+	atlas.setFormat(GxmTexture::U8_R111);
+	atlas.create(GxmTexture::Point, GxmTexture::Point);
+
+	// restoring the empty skyline resets the packer without touching pixels
+	auto empty = atlas.skyline();
+
+	ListSkyline list;
+	std::vector<TextureAtlas::AtlasRegion> regions(sizes.size());
+
+	std::printf("%zu rectangles from %ux%u to %ux%u, into %dx%d\n", sizes.size(), 2, 4, 31, 33, ATLAS_SIZE, ATLAS_SIZE);
+
+	auto listTime = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		list.clear();
+
+		for (auto i = 0u; i < sizes.size(); ++i)
+		{
+			regions[i] = list.region(sizes[i].x, sizes[i].y);
+		}
+	});
+
+	report("std::list, in order (before)", listTime, sizes.size(), packing(regions));
+
+	auto vectorTime = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		atlas.setSkyline(empty);
+
+		for (auto i = 0u; i < sizes.size(); ++i)
+		{
+			regions[i] = atlas.region(sizes[i].x, sizes[i].y);
+		}
+	});
+
+	report("vector, in order", vectorTime, sizes.size(), packing(regions));
+
+	auto batchTime = Benchmark::measure(ITERATIONS, [&](unsigned int)
+	{
+		atlas.setSkyline(empty);
+		regions = atlas.regionBatch(sizes);
+	});
+
+	report("vector, regionBatch", batchTime, sizes.size(), packing(regions));
+
+	// what an atlas sees in use: the glyphs of a line of text at a time
+	std::vector<glm::uvec2> line(sizes.begin(), sizes.begin() + 40);
+
+	auto partial = Benchmark::measure(ITERATIONS*100, [&](unsigned int)
+	{
+		atlas.setSkyline(empty);
+
+		for (auto& size : line)
+		{
+			auto region = atlas.region(size.x, size.y);
+			Benchmark::keep(region);
+		}
+	});
+
+	auto partialList = Benchmark::measure(ITERATIONS*100, [&](unsigned int)
+	{
+		list.clear();
+
+		for (auto& size : line)
+		{
+			auto region = list.region(size.x, size.y);
+			Benchmark::keep(region);
+		}
+	});
+
+	Benchmark::report("a line of 40 glyphs: std::list (before)", partialList);
+	Benchmark::report("a line of 40 glyphs: vector", partial);
+
+	return 0;
+}
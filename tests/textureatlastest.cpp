@@ -0,0 +1,236 @@
+/*
+ * textureatlastest.cpp - skyline packing of atlas regions
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <textureatlas.h>
+
+#include "test.h"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+	constexpr int ATLAS_SIZE = 512;
+
+	// glyph sized rectangles, the same ones every run
+	std::vector<glm::uvec2> glyphSizes(std::size_t count, unsigned int seed)
+	{
+		std::vector<glm::uvec2> sizes;
+
+		for (auto i = 0u; i < count; ++i)
+		{
+			seed = seed*1103515245 + 12345;
+			auto width = 2 + (seed >> 16)%30;
+			seed = seed*1103515245 + 12345;
+			auto height = 4 + (seed >> 16)%30;
+			sizes.push_back(glm::uvec2(width, height));
+		}
+
+		return sizes;
+	}
+
+	bool placed(const TextureAtlas::AtlasRegion& region)
+	{
+		return region.x != -1 && region.y != -1;
+	}
+
+	// regions, with the border each carries, lie inside the atlas less its
+	// outer row and column and never overlap one another. returns the
+	// pixels covered
+	std::size_t checkRegions(const std::vector<TextureAtlas::AtlasRegion>& regions, int top = 1)
+	{
+		std::vector<bool> covered(ATLAS_SIZE*ATLAS_SIZE);
+		std::size_t area = 0;
+		auto outside = 0u, overlaps = 0u;
+
+		for (auto& region : regions)
+		{
+			if (!placed(region))
+				continue;
+
+			if (region.x < 1 || region.y < top || region.x + region.z > ATLAS_SIZE-1 || region.y + region.w > ATLAS_SIZE-1)
+			{
+				++outside;
+				continue;
+			}
+
+			for (auto y = region.y; y < region.y + region.w; ++y)
+			{
+				for (auto x = region.x; x < region.x + region.z; ++x)
+				{
+					overlaps += covered[y*ATLAS_SIZE + x];
+					covered[y*ATLAS_SIZE + x] = true;
+				}
+			}
+
+			area += region.z*region.w;
+		}
+
+		CHECK(outside == 0);
+		CHECK(overlaps == 0);
+		return area;
+	}
+
+	// the skyline spans columns 1 to width-1 without gaps, with neighbouring
+	// nodes always at different heights, and lies on or above every region
+	void checkSkyline(const TextureAtlas& atlas, const std::vector<TextureAtlas::AtlasRegion>& regions)
+	{
+		auto& skyline = atlas.skyline();
+		std::vector<int> heights(ATLAS_SIZE, -1);
+		auto x = 1;
+		auto unmerged = 0u;
+
+		for (auto i = 0u; i < skyline.size(); ++i)
+		{
+			auto& node = skyline[i];
+
+			if (!CHECK(node.x == x && node.z > 0))
+				return;
+
+			unmerged += i > 0 && skyline[i-1].y == node.y;
+
+			for (auto column = node.x; column < node.x + node.z; ++column)
+			{
+				heights[column] = node.y;
+			}
+
+			x += node.z;
+		}
+
+		CHECK(x == ATLAS_SIZE-1);
+		CHECK(unmerged == 0);
+
+		auto below = 0u;
+
+		for (auto& region : regions)
+		{
+			if (!placed(region))
+				continue;
+
+			for (auto column = region.x; column < region.x + region.z; ++column)
+			{
+				below += heights[column] < region.y + region.w;
+			}
+		}
+
+		CHECK(below == 0);
+	}
+}
+
+int main(void)
+{
+	auto atlas = std::make_unique<TextureAtlas>(ATLAS_SIZE, ATLAS_SIZE);
+	atlas->setFormat(GxmTexture::U8_R111);
+	atlas->create(GxmTexture::Point, GxmTexture::Point);
+
+	auto sizes = glyphSizes(2000, 1);
+
+	// one at a time until the atlas is full
+	std::vector<TextureAtlas::AtlasRegion> regions;
+	auto misses = 0u;
+
+	for (auto& size : sizes)
+	{
+		auto region = atlas->region(size.x, size.y);
+		misses += !placed(region);
+
+		// each region is its size and a border to the right and below
+		CHECK(!placed(region) || (region.z == static_cast<int>(size.x+1) && region.w == static_cast<int>(size.y+1)));
+		regions.push_back(region);
+	}
+
+	CHECK(misses > 0 && misses < sizes.size());
+
+	auto area = checkRegions(regions);
+	checkSkyline(*atlas, regions);
+
+	// anything small enough still finds a gap once large ones stop fitting
+	CHECK(area > ATLAS_SIZE*ATLAS_SIZE*3/4);
+
+	// a batch on an empty atlas goes tallest first, and hands back regions
+	// in the order it was given sizes
+	atlas->clear();
+
+	auto batch = atlas->regionBatch(sizes);
+	auto batchMisses = 0u;
+	auto wrongSize = 0u;
+
+	CHECK(batch.size() == sizes.size());
+
+	for (auto i = 0u; i < batch.size(); ++i)
+	{
+		if (!placed(batch[i]))
+		{
+			++batchMisses;
+			wrongSize += batch[i].z != 0 || batch[i].w != 0;
+			continue;
+		}
+
+		wrongSize += batch[i].z != static_cast<int>(sizes[i].x+1) || batch[i].w != static_cast<int>(sizes[i].y+1);
+	}
+
+	CHECK(wrongSize == 0);
+
+	auto batchArea = checkRegions(batch);
+	checkSkyline(*atlas, batch);
+
+	// the point of a batch: more of the atlas is used by the same rectangles
+	CHECK(batchMisses > 0);
+	CHECK(batchArea > area);
+
+	// a batch added to a partly full atlas packs around what is there
+	atlas->clear();
+
+	std::vector<glm::uvec2> first(sizes.begin(), sizes.begin() + 200);
+	std::vector<glm::uvec2> second(sizes.begin() + 200, sizes.begin() + 400);
+
+	auto both = atlas->regionBatch(first);
+	auto more = atlas->regionBatch(second);
+	both.insert(both.end(), more.begin(), more.end());
+
+	checkRegions(both);
+	checkSkyline(*atlas, both);
+
+	// reserved rows are never handed out
+	atlas->clear();
+	atlas->reserve(100);
+
+	std::vector<TextureAtlas::AtlasRegion> reserved;
+
+	for (auto i = 0u; i < 300; ++i)
+	{
+		reserved.push_back(atlas->region(sizes[i].x, sizes[i].y));
+	}
+
+	checkRegions(reserved, 100);
+	checkSkyline(*atlas, reserved);
+
+	// a saved skyline restored packs exactly as it did before
+	auto saved = atlas->skyline();
+	auto next = atlas->region(20, 20);
+	atlas->region(30, 30);
+	atlas->setSkyline(saved);
+
+	CHECK(atlas->region(20, 20) == next);
+
+	// nothing bigger than the atlas fits, and trying changes nothing
+	auto skyline = atlas->skyline();
+
+	CHECK(!placed(atlas->region(ATLAS_SIZE, 1)));
+	CHECK(!placed(atlas->region(1, ATLAS_SIZE)));
+	CHECK(atlas->skyline() == skyline);
+
+	// an empty atlas fits exactly its size less the borders
+	atlas->clear();
+
+	CHECK(placed(atlas->region(ATLAS_SIZE-3, ATLAS_SIZE-3)));
+	CHECK(!placed(atlas->region(1, 1)));
+
+	return Test::result();
+}
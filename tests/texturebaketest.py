@@ -0,0 +1,203 @@
+#!/usr/bin/python
+import sys, os, struct, math
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools"))
+import texturebake
+
+# decodes block compressed textures baked by texturebake.py, independently of
+# its encoder, and compares them with the png they were baked from. the
+# decoder is first checked against blocks worked out by hand, so a broken
+# encoder cannot be hidden by a decoder that makes the same mistake.
+#
+# usage: texturebaketest.py [baked.rtex source.png]...
+
+# per channel, on the 0-255 scale. block compression loses most on sharp
+# edges, the background layers are soft so they stay well within these
+MAX_RMSE = 6.0
+MAX_ALPHA_RMSE = 2.0
+
+def expand565(colour):
+	r = (colour >> 11) & 0x1f
+	g = (colour >> 5) & 0x3f
+	b = colour & 0x1f
+	return ((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2))
+
+def decode_colour_block(data, forceFourColour):
+	c0, c1, indices = struct.unpack("<HHI", data)
+	p0 = expand565(c0)
+	p1 = expand565(c1)
+
+	# ubc3 colour blocks are always four colour, ubc1 picks by the endpoints
+	if c0 > c1 or forceFourColour:
+		palette = [p0 + (255,), p1 + (255,),
+			tuple((2*a + b) // 3 for a, b in zip(p0, p1)) + (255,),
+			tuple((a + 2*b) // 3 for a, b in zip(p0, p1)) + (255,)]
+	else:
+		palette = [p0 + (255,), p1 + (255,), tuple((a + b) // 2 for a, b in zip(p0, p1)) + (255,), (0, 0, 0, 0)]
+
+	return [palette[(indices >> (2*i)) & 3] for i in range(16)]
+
+def decode_alpha_block(data):
+	a0, a1 = struct.unpack("<BB", data[:2])
+	indices = struct.unpack("<Q", data[2:8] + b"\0\0")[0]
+
+	if a0 > a1:
+		palette = [a0, a1] + [((7 - n) * a0 + n * a1) // 7 for n in range(1, 7)]
+	else:
+		palette = [a0, a1] + [((5 - n) * a0 + n * a1) // 5 for n in range(1, 5)] + [0, 255]
+
+	return [palette[(indices >> (3*i)) & 7] for i in range(16)]
+
+def block_index(bx, by, blocksWide, blocksHigh, swizzled):
+	if not swizzled:
+		return by * blocksWide + bx
+
+	# square tiles of the smaller dimension, morton ordered inside
+	bits = min(blocksWide, blocksHigh).bit_length() - 1
+	size = 1 << bits
+	tile = (by >> bits) * (blocksWide >> bits) + (bx >> bits)
+	index = 0
+
+	for bit in range(bits):
+		index |= (((bx & (size - 1)) >> bit) & 1) << (2*bit)
+		index |= (((by & (size - 1)) >> bit) & 1) << (2*bit + 1)
+
+	return tile * size * size + index
+
+def decode(texture):
+	magic, version, format, width, height, stride, flags, offset = struct.unpack_from(texturebake.HEADER_FORMAT, texture, 0)
+
+	if magic != texturebake.TEXTURE_MAGIC or version != texturebake.TEXTURE_VERSION:
+		raise ValueError("not a baked texture")
+
+	if format not in (texturebake.FORMAT_UBC1, texturebake.FORMAT_UBC3):
+		raise ValueError("not a block compressed texture")
+
+	blockBytes = 8 if format == texturebake.FORMAT_UBC1 else 16
+	blocksWide = (width + 3) // 4
+	blocksHigh = (height + 3) // 4
+	swizzled = (flags & texturebake.FLAG_SWIZZLED) != 0
+
+	if stride != blocksWide * blockBytes:
+		raise ValueError("stride %d does not match the width" % stride)
+
+	pixels = [None] * (width * height)
+
+	for by in range(blocksHigh):
+		for bx in range(blocksWide):
+			src = offset + block_index(bx, by, blocksWide, blocksHigh, swizzled) * blockBytes
+
+			if format == texturebake.FORMAT_UBC3:
+				alpha = decode_alpha_block(texture[src:src + 8])
+				colour = decode_colour_block(texture[src + 8:src + 16], True)
+				block = [c[:3] + (a,) for c, a in zip(colour, alpha)]
+			else:
+				block = decode_colour_block(texture[src:src + 8], False)
+
+			for i, pixel in enumerate(block):
+				x = bx*4 + i % 4
+				y = by*4 + i // 4
+
+				if x < width and y < height:
+					pixels[y * width + x] = pixel
+
+	return width, height, pixels
+
+def rmse(errors):
+	return math.sqrt(sum(e * e for e in errors) / float(len(errors)))
+
+def check_reference_blocks():
+	failures = 0
+
+	# red and blue endpoints, one pixel of each palette entry then repeated
+	block = struct.pack("<HHI", 0xf800, 0x001f, 0xe4e4e4e4)
+	expected = [(255, 0, 0, 255), (0, 0, 255, 255), (170, 0, 85, 255), (85, 0, 170, 255)] * 4
+
+	if decode_colour_block(block, False) != expected:
+		print("four colour reference block decoded wrongly")
+		failures += 1
+
+	# c0 <= c1 is the three colour mode, index 3 is transparent black
+	block = struct.pack("<HHI", 0x001f, 0xf800, 0xe4e4e4e4)
+	expected = [(0, 0, 255, 255), (255, 0, 0, 255), (127, 0, 127, 255), (0, 0, 0, 0)] * 4
+
+	if decode_colour_block(block, False) != expected:
+		print("three colour reference block decoded wrongly")
+		failures += 1
+
+	# eight alphas between 255 and 0 in order, twice
+	indices = sum(n << (3*n) for n in range(8)) | sum(n << (3*(n + 8)) for n in range(8))
+	block = struct.pack("<BB", 255, 0) + struct.pack("<Q", indices)[:6]
+	expected = [255, 0, 218, 182, 145, 109, 72, 36] * 2
+
+	if decode_alpha_block(block) != expected:
+		print("alpha reference block decoded wrongly")
+		failures += 1
+
+	return failures
+
+def check_encoder():
+	failures = 0
+
+	# colours 565 can hold exactly, and a block with punchthrough alpha,
+	# must come back unchanged
+	solid = bytearray((255, 0, 0, 255) * 16)
+	cut = bytearray((0, 255, 0, 255) * 8 + (0, 0, 0, 0) * 8)
+
+	for name, pixels in (("solid", solid), ("punchthrough", cut)):
+		data = texturebake.compress(pixels, 4, 4, texturebake.FORMAT_UBC1)
+		decoded = decode_colour_block(bytes(data), False)
+		original = [tuple(pixels[i*4:i*4 + 4]) for i in range(16)]
+
+		if [p if p[3] else (0, 0, 0, 0) for p in original] != decoded:
+			print("%s block did not survive ubc1" % name)
+			failures += 1
+
+	return failures
+
+def compare(bakedFile, sourceFile):
+	with open(bakedFile, 'rb') as f:
+		width, height, decoded = decode(f.read())
+
+	sourceWidth, sourceHeight, source = texturebake.read_png(sourceFile)
+
+	if (width, height) != (sourceWidth, sourceHeight):
+		print("%s: %dx%d, the png is %dx%d" % (bakedFile, width, height, sourceWidth, sourceHeight))
+		return 1
+
+	colour = [[], [], []]
+	alpha = []
+	worst = 0
+
+	# colour is compared premultiplied, as it is blended. what is under a
+	# nearly transparent pixel hardly shows, and the encoder spends nothing
+	# on it
+	for i, pixel in enumerate(decoded):
+		original = source[i*4:i*4 + 4]
+
+		for channel in range(3):
+			error = (pixel[channel] * pixel[3] - original[channel] * original[3]) / 255.0
+			colour[channel].append(error)
+			worst = max(worst, abs(error))
+
+		alpha.append(pixel[3] - original[3])
+
+	errors = [rmse(c) for c in colour]
+	alphaError = rmse(alpha)
+
+	print("%s: rmse r %.2f g %.2f b %.2f a %.2f, worst %.0f" % (os.path.basename(bakedFile), errors[0], errors[1], errors[2], alphaError, worst))
+
+	if max(errors) > MAX_RMSE or alphaError > MAX_ALPHA_RMSE:
+		print("%s: too far from %s" % (bakedFile, sourceFile))
+		return 1
+
+	return 0
+
+if __name__ == "__main__":
+	failures = check_reference_blocks() + check_encoder()
+	args = sys.argv[1:]
+
+	for baked, source in zip(args[0::2], args[1::2]):
+		failures += compare(baked, source)
+
+	sys.exit(1 if failures else 0)
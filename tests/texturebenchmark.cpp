@@ -0,0 +1,65 @@
+/*
+ * texturebenchmark.cpp - png decoding against loading baked textures
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <resource.h>
+#include <texturecache.h>
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+	struct Source
+	{
+		const char *label;
+		std::string file;
+	};
+
+	void measure(const char *name, const Source& source)
+	{
+		auto file = Resource::view(source.file);
+		auto storage = TextureCache::instance()->texture(source.file)->storageSize();
+
+		// every load is cold, the handle is the only reference
+		auto ns = Benchmark::measure(4, [&source](unsigned int)
+		{
+			auto texture = TextureCache::instance()->texture(source.file);
+			Benchmark::keep(texture);
+		});
+
+		std::printf("%-20s %-6s %8zu bytes read %8zu bytes of texture %10.2f ms\n", name, source.label, file.size, storage, ns/1e6);
+	}
+}
+
+int main(void)
+{
+	if (!Resource::view("app0:/textures/bgbase.png").good)
+	{
+		std::fprintf(stderr, "run from the build directory, app0:/ is read from there\n");
+		return 1;
+	}
+
+	// each texture the installer draws, decoded from its png, loaded from an
+	// uncompressed bake, and loaded as it ships. decoding runs on one of the
+	// background workers, the same as in the installer
+	const char *names[] = { "bgbase", "bgspec1", "bgspec2", "bgspec3", "bgspec4", "checkbox-checked", "checkbox-unchecked" };
+
+	for (auto name : names)
+	{
+		auto background = std::string(name).compare(0, 2, "bg") == 0;
+
+		measure(name, { "png", std::string("app0:/textures/") + name + ".png" });
+		measure(name, { "argb8", std::string("app0:/textures/argb8/") + name + ".rtex" });
+		measure(name, { "ships", background ? std::string("app0:/textures/") + name + ".rtex" : std::string("rsc:/textures/") + name + ".rtex" });
+	}
+
+	return 0;
+}
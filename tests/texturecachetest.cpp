@@ -0,0 +1,51 @@
+/*
+ * texturecachetest.cpp - shared textures and batched decodes
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <texturecache.h>
+
+#include "test.h"
+
+#include <string>
+#include <vector>
+
+int main(void)
+{
+	auto cache = TextureCache::instance();
+	auto before = cache->statistics();
+
+	const std::string checked = "rsc:/textures/checkbox-checked.rtex";
+	const std::string unchecked = "rsc:/textures/checkbox-unchecked.rtex";
+
+	// a path given twice in a batch is decoded once, and both indices
+	// share it
+	auto textures = cache->textures({ checked, unchecked, checked });
+	auto statistics = cache->statistics();
+
+	CHECK(textures.size() == 3);
+	CHECK(textures[0] && textures[1] && textures[2]);
+	CHECK(textures[0] == textures[2]);
+	CHECK(textures[0] != textures[1]);
+	CHECK(statistics.misses - before.misses == 2);
+	CHECK(statistics.hits - before.hits == 1);
+	CHECK(statistics.bytesResident - before.bytesResident == textures[0]->storageSize() + textures[1]->storageSize());
+
+	// while a handle is held the path is not decoded again
+	auto again = cache->texture(checked);
+
+	CHECK(again == textures[0]);
+	CHECK(cache->statistics().misses == statistics.misses);
+
+	// and once every handle is gone, nothing is left resident
+	again.reset();
+	textures.clear();
+
+	CHECK(cache->statistics().bytesResident == before.bytesResident);
+
+	return Test::result();
+}
@@ -0,0 +1,105 @@
+/*
+ * vertextypestest.cpp - the packing of the compact vertex formats
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+#include <vertextypes.h>
+
+#include "test.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	// the bytes the gpu reads, in memory order
+	template <typename T>
+	void bytes(const T& value, std::uint8_t *out)
+	{
+		std::memcpy(out, &value, sizeof(T));
+	}
+} // anonymous namespace
+
+int main(void)
+{
+	// a vertex is the size of the attributes it declares, with no padding
+	CHECK(sizeof(CompactGeometryVertex) == 8);
+	CHECK(sizeof(CompactTextureVertex) == 12);
+	CHECK(sizeof(TextVertex) == 8);
+	CHECK(offsetof(TextVertex, texCoord) == 4);
+
+	// quarter units, rounded to the nearest and halves away from zero
+	CHECK(FixedPosition::fixed(0.f) == 0);
+	CHECK(FixedPosition::fixed(1.f) == 4);
+	CHECK(FixedPosition::fixed(1.3f) == 5);
+	CHECK(FixedPosition::fixed(1.4f) == 6);
+	CHECK(FixedPosition::fixed(0.125f) == 1);
+	CHECK(FixedPosition::fixed(-0.125f) == -1);
+	CHECK(FixedPosition::fixed(-2.6f) == -10);
+
+	// past 8192 units either way a position sticks to the edge rather than
+	// wrapping to the other side of the screen
+	CHECK(FixedPosition::fixed(8191.75f) == INT16_MAX);
+	CHECK(FixedPosition::fixed(8192.f) == INT16_MAX);
+	CHECK(FixedPosition::fixed(1e9f) == INT16_MAX);
+	CHECK(FixedPosition::fixed(-8192.f) == INT16_MIN);
+	CHECK(FixedPosition::fixed(-1e9f) == INT16_MIN);
+
+	FixedPosition fixed;
+	fixed = glm::vec2(12.5f, -3.25f);
+
+	CHECK(fixed.x == 50 && fixed.y == -13);
+
+	// colours are r, g, b, a a byte each, the order U8N reads them in
+	PackedColour colour;
+	colour = glm::vec4(1.f, 0.f, 0.2f, 0.6f);
+
+	std::uint8_t rgba[4];
+	bytes(colour, rgba);
+
+	CHECK(rgba[0] == 255 && rgba[1] == 0 && rgba[2] == 51 && rgba[3] == 153);
+
+	// and out of range components are clamped, not wrapped
+	colour = glm::vec4(2.f, -1.f, 0.5f, 1.f);
+	bytes(colour, rgba);
+
+	CHECK(rgba[0] == 255 && rgba[1] == 0 && rgba[2] == 128 && rgba[3] == 255);
+
+	// positions are two half floats, x first. z is dropped
+	PackedPosition position;
+	position = glm::vec3(1.5f, -2.f, 9.f);
+
+	CHECK(position.value == 0xC0003E00u);
+
+	position = glm::vec3(960.5f, 544.f, 0.f);
+
+	auto unpacked = glm::unpackHalf2x16(position.value);
+	CHECK(unpacked.x == 960.5f && unpacked.y == 544.f);
+
+	// texture coordinates are two 16 bit normalised values, u first
+	PackedTexCoord texCoord;
+	texCoord = glm::vec2(0.f, 1.f);
+
+	CHECK(texCoord.value == 0xFFFF0000u);
+
+	texCoord = glm::vec2(0.5f, 0.25f);
+
+	CHECK((texCoord.value & 0xFFFF) == 32768);
+	CHECK((texCoord.value >> 16) == 16384);
+
+	texCoord = glm::vec2(-0.5f, 1.5f);
+
+	CHECK(texCoord.value == 0xFFFF0000u);
+
+	// a glyph in a 512 texel page lands on its texel
+	texCoord = glm::vec2(37.f/512.f, 511.f/512.f);
+
+	auto uv = glm::unpackUnorm2x16(texCoord.value);
+	CHECK(std::lround(uv.x*512.f) == 37 && std::lround(uv.y*512.f) == 511);
+
+	return Test::result();
+}
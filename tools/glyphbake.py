@@ -0,0 +1,408 @@
+#!/usr/bin/python
+import sys, os, errno, struct, math, ctypes, ctypes.util
+
+# baked glyph layout, all little endian:
+#   header   magic, version, page count
+#   pages    one per point size and kind, see PAGE_FORMAT
+#   glyphs   GLYPH_FORMAT records for each page
+#   kerning  KERNING_FORMAT records for each page, only non zero pairs
+#   bitmaps  the used rows of each page's atlas, aligned to DATA_ALIGNMENT
+GLYPHS_MAGIC = b"RGLY"
+GLYPHS_VERSION = 1
+HEADER_FORMAT = "<4sII"
+
+# 26.6 size, atlas width, atlas height, used rows, flags, glyph count,
+# glyph offset, kerning count, kerning offset, bitmap offset
+PAGE_FORMAT = "<iIIIIIIIII"
+PAGE_FLAG_KERNING = 1
+
+# a signed distance field of each glyph rather than its bitmap. advances and
+# kerning are in 26.6 fixed point since the page is drawn at any size
+PAGE_FLAG_DISTANCE_FIELD = 2
+
+# must match DistanceField::SPREAD
+DISTANCE_FIELD_SPREAD = 4
+
+# codepoint, atlas region x, y, width, height, advance x, y, bitmap left, top
+GLYPH_FORMAT = "<IHHHHhhhh"
+
+# previous codepoint, codepoint, offset x, y
+KERNING_FORMAT = "<IIhh"
+
+DATA_ALIGNMENT = 16
+
+# must match CharacterAtlas, which packs into a single 512x512 page
+ATLAS_WIDTH = 512
+ATLAS_HEIGHT = 512
+
+# the same resolution GlyphStore hands FT_Set_Char_Size
+HORIZONTAL_DPI = int(960 / 4.357877685622746)
+VERTICAL_DPI = int(544 / 2.451306198162795)
+
+FT_FACE_FLAG_KERNING = 1 << 6
+FT_LOAD_DEFAULT = 0
+FT_LOAD_NO_HINTING = 2
+FT_RENDER_MODE_NORMAL = 0
+FT_KERNING_DEFAULT = 0
+FT_KERNING_UNFITTED = 1
+
+FAR = 1e20
+
+def align(value, alignment):
+	return (value + alignment - 1) & ~(alignment - 1)
+
+class FT_Generic(ctypes.Structure):
+	_fields_ = [("data", ctypes.c_void_p), ("finalizer", ctypes.c_void_p)]
+
+class FT_Vector(ctypes.Structure):
+	_fields_ = [("x", ctypes.c_long), ("y", ctypes.c_long)]
+
+class FT_BBox(ctypes.Structure):
+	_fields_ = [("xMin", ctypes.c_long), ("yMin", ctypes.c_long), ("xMax", ctypes.c_long), ("yMax", ctypes.c_long)]
+
+class FT_Bitmap(ctypes.Structure):
+	_fields_ = [
+		("rows", ctypes.c_uint),
+		("width", ctypes.c_uint),
+		("pitch", ctypes.c_int),
+		("buffer", ctypes.POINTER(ctypes.c_ubyte)),
+		("num_grays", ctypes.c_ushort),
+		("pixel_mode", ctypes.c_ubyte),
+		("palette_mode", ctypes.c_ubyte),
+		("palette", ctypes.c_void_p),
+	]
+
+class FT_Glyph_Metrics(ctypes.Structure):
+	_fields_ = [(name, ctypes.c_long) for name in ("width", "height", "horiBearingX", "horiBearingY", "horiAdvance", "vertBearingX", "vertBearingY", "vertAdvance")]
+
+class FT_GlyphSlotRec(ctypes.Structure):
+	_fields_ = [
+		("library", ctypes.c_void_p),
+		("face", ctypes.c_void_p),
+		("next", ctypes.c_void_p),
+		("glyph_index", ctypes.c_uint),
+		("generic", FT_Generic),
+		("metrics", FT_Glyph_Metrics),
+		("linearHoriAdvance", ctypes.c_long),
+		("linearVertAdvance", ctypes.c_long),
+		("advance", FT_Vector),
+		("format", ctypes.c_uint),
+		("bitmap", FT_Bitmap),
+		("bitmap_left", ctypes.c_int),
+		("bitmap_top", ctypes.c_int),
+	]
+
+class FT_FaceRec(ctypes.Structure):
+	_fields_ = [
+		("num_faces", ctypes.c_long),
+		("face_index", ctypes.c_long),
+		("face_flags", ctypes.c_long),
+		("style_flags", ctypes.c_long),
+		("num_glyphs", ctypes.c_long),
+		("family_name", ctypes.c_char_p),
+		("style_name", ctypes.c_char_p),
+		("num_fixed_sizes", ctypes.c_int),
+		("available_sizes", ctypes.c_void_p),
+		("num_charmaps", ctypes.c_int),
+		("charmaps", ctypes.c_void_p),
+		("generic", FT_Generic),
+		("bbox", FT_BBox),
+		("units_per_EM", ctypes.c_ushort),
+		("ascender", ctypes.c_short),
+		("descender", ctypes.c_short),
+		("height", ctypes.c_short),
+		("max_advance_width", ctypes.c_short),
+		("max_advance_height", ctypes.c_short),
+		("underline_position", ctypes.c_short),
+		("underline_thickness", ctypes.c_short),
+		("glyph", ctypes.POINTER(FT_GlyphSlotRec)),
+	]
+
+def load_freetype():
+	library = ctypes.util.find_library("freetype")
+
+	if library is None:
+		raise RuntimeError("could not find the freetype library")
+
+	ft = ctypes.CDLL(library)
+	ft.FT_Init_FreeType.argtypes = [ctypes.POINTER(ctypes.c_void_p)]
+	ft.FT_New_Memory_Face.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_long, ctypes.c_long, ctypes.POINTER(ctypes.POINTER(FT_FaceRec))]
+	ft.FT_Set_Char_Size.argtypes = [ctypes.POINTER(FT_FaceRec), ctypes.c_long, ctypes.c_long, ctypes.c_uint, ctypes.c_uint]
+	ft.FT_Get_Char_Index.argtypes = [ctypes.POINTER(FT_FaceRec), ctypes.c_ulong]
+	ft.FT_Get_Char_Index.restype = ctypes.c_uint
+	ft.FT_Load_Glyph.argtypes = [ctypes.POINTER(FT_FaceRec), ctypes.c_uint, ctypes.c_int32]
+	ft.FT_Render_Glyph.argtypes = [ctypes.POINTER(FT_GlyphSlotRec), ctypes.c_int]
+	ft.FT_Get_Kerning.argtypes = [ctypes.POINTER(FT_FaceRec), ctypes.c_uint, ctypes.c_uint, ctypes.c_uint, ctypes.POINTER(FT_Vector)]
+	ft.FT_Done_Face.argtypes = [ctypes.POINTER(FT_FaceRec)]
+	ft.FT_Done_FreeType.argtypes = [ctypes.c_void_p]
+	return ft
+
+def parse_charset(spec):
+	# comma separated codepoints or inclusive ranges, eg. 0x20-0x7e,0xa9
+	charset = []
+
+	for part in spec.split(","):
+		if "-" in part:
+			first, last = part.split("-")
+			charset.extend(range(int(first, 0), int(last, 0) + 1))
+		else:
+			charset.append(int(part, 0))
+
+	return sorted(set(charset))
+
+class Packer(object):
+	# simple shelf packing. regions include a one pixel border on their right
+	# and bottom edge and the page keeps a one pixel margin, the same as
+	# TextureAtlas, so glyphs added at runtime can share the page
+	def __init__(self, width, height):
+		self.width = width
+		self.height = height
+		self.x = 1
+		self.y = 1
+		self.shelf = 0
+
+	def region(self, width, height):
+		width += 1
+		height += 1
+
+		if self.x + width > self.width - 1:
+			self.x = 1
+			self.y += self.shelf
+			self.shelf = 0
+
+		if self.y + height > self.height - 1:
+			raise ValueError("glyphs do not fit in a %dx%d atlas" % (self.width, self.height))
+
+		region = (self.x, self.y, width, height)
+		self.x += width
+		self.shelf = max(self.shelf, height)
+		return region
+
+	def used(self):
+		return self.y + self.shelf
+
+def transform(f):
+	# felzenszwalb and huttenlocher's squared distance transform, the same one
+	# DistanceField::generate applies to each row and column
+	n = len(f)
+	d = [0.0] * n
+	v = [0] * n
+	z = [0.0] * (n + 1)
+	k = 0
+	z[0] = -FAR
+	z[1] = FAR
+
+	for q in range(1, n):
+		s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / float(2*q - 2*v[k])
+
+		while s <= z[k]:
+			k -= 1
+			s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k])) / float(2*q - 2*v[k])
+
+		k += 1
+		v[k] = q
+		z[k] = s
+		z[k + 1] = FAR
+
+	k = 0
+
+	for q in range(n):
+		while z[k + 1] < q:
+			k += 1
+
+		d[q] = (q - v[k]) ** 2 + f[v[k]]
+
+	return d
+
+def transform_grid(grid, width, height):
+	columns = [transform(grid[x::width]) for x in range(width)]
+	grid = [columns[x][y] for y in range(height) for x in range(width)]
+	return [value for y in range(height) for value in transform(grid[y*width:(y + 1)*width])]
+
+def distance_field(rows, width, height):
+	# pad by the spread on every edge, the outline ends up at 128
+	spread = DISTANCE_FIELD_SPREAD
+	field_width = width + 2*spread
+	field_height = height + 2*spread
+	coverage = [0.0] * (field_width * field_height)
+
+	for y, row in enumerate(rows):
+		for x in range(width):
+			coverage[(y + spread) * field_width + x + spread] = row[x] / 255.0
+
+	outside = transform_grid([0.0 if c >= 0.5 else FAR for c in coverage], field_width, field_height)
+	inside = transform_grid([FAR if c >= 0.5 else 0.0 for c in coverage], field_width, field_height)
+	field = bytearray(len(coverage))
+
+	for i, c in enumerate(coverage):
+		# antialiased pixels straddle the outline, so use their coverage
+		if 0.0 < c < 1.0:
+			distance = 0.5 - c
+		elif c >= 0.5:
+			distance = 0.5 - math.sqrt(inside[i])
+		else:
+			distance = math.sqrt(outside[i]) - 0.5
+
+		value = min(max(0.5 - distance / (2*spread), 0.0), 1.0)
+		field[i] = int(math.floor(value * 255.0 + 0.5))
+
+	rows = [field[y*field_width:(y + 1)*field_width] for y in range(field_height)]
+	return rows, field_width, field_height
+
+def render_glyph(ft, face, character, distance, load_flags=FT_LOAD_DEFAULT):
+	# the bitmap or distance field of a glyph with its metrics, the same way
+	# CharacterAtlas::addGlyph and GlyphStore::addDistanceField store them
+	index = ft.FT_Get_Char_Index(face, character)
+
+	if index == 0:
+		return None
+
+	ft.FT_Load_Glyph(face, index, load_flags)
+	ft.FT_Render_Glyph(face.contents.glyph, FT_RENDER_MODE_NORMAL)
+
+	slot = face.contents.glyph.contents
+	bitmap = slot.bitmap
+	width = bitmap.width
+	height = bitmap.rows
+	rows = [bytearray(bitmap.buffer[y * bitmap.pitch:y * bitmap.pitch + width]) for y in range(height)]
+	left = slot.bitmap_left
+	top = slot.bitmap_top
+
+	if not distance:
+		return width, height, rows, (slot.linearHoriAdvance >> 16, slot.linearVertAdvance >> 16), left, top
+
+	# advances are 16.16, stored as 26.6
+	advance = (slot.linearHoriAdvance >> 10, slot.linearVertAdvance >> 10)
+
+	if width == 0 or height == 0:
+		return width, height, rows, advance, left, top
+
+	rows, width, height = distance_field(rows, width, height)
+	return width, height, rows, advance, left - DISTANCE_FIELD_SPREAD, top + DISTANCE_FIELD_SPREAD
+
+def bake_page(ft, face, size, charset, distance=False):
+	ft.FT_Set_Char_Size(face, 0, int(size * 64), HORIZONTAL_DPI, VERTICAL_DPI)
+
+	packer = Packer(ATLAS_WIDTH, ATLAS_HEIGHT)
+	atlas = bytearray(ATLAS_WIDTH * ATLAS_HEIGHT)
+	glyphs = []
+
+	# tallest first packs the shelves far more tightly
+	rendered = []
+
+	for character in charset:
+		glyph = render_glyph(ft, face, character, distance)
+
+		if glyph is not None:
+			rendered.append((character,) + glyph)
+
+	rendered.sort(key=lambda glyph: -glyph[2])
+
+	for character, width, height, rows, advance, left, top in rendered:
+		x, y, region_width, region_height = packer.region(width, height)
+
+		for row, data in enumerate(rows):
+			start = (y + row) * ATLAS_WIDTH + x
+			atlas[start:start + width] = data
+
+		glyphs.append(struct.pack(GLYPH_FORMAT, character, x, y, region_width, region_height, advance[0], advance[1], left, top))
+
+	kerning = []
+	flags = PAGE_FLAG_DISTANCE_FIELD if distance else 0
+
+	if face.contents.face_flags & FT_FACE_FLAG_KERNING:
+		flags |= PAGE_FLAG_KERNING
+		indices = [(c, ft.FT_Get_Char_Index(face, c)) for c in charset]
+		delta = FT_Vector()
+
+		# distance fields keep unrounded 26.6 kerning, bitmaps whole pixels
+		mode = FT_KERNING_UNFITTED if distance else FT_KERNING_DEFAULT
+		shift = 0 if distance else 6
+
+		for prev, prev_index in indices:
+			for character, index in indices:
+				ft.FT_Get_Kerning(face, prev_index, index, mode, ctypes.byref(delta))
+
+				if delta.x >> shift or delta.y >> shift:
+					kerning.append(struct.pack(KERNING_FORMAT, prev, character, delta.x >> shift, delta.y >> shift))
+
+	used = packer.used()
+	return size, flags, used, glyphs, kerning, bytes(atlas[:used * ATLAS_WIDTH])
+
+def open_face(ft, filename):
+	with open(filename, 'rb') as f:
+		font = f.read()
+
+	library = ctypes.c_void_p()
+	face = ctypes.POINTER(FT_FaceRec)()
+	ft.FT_Init_FreeType(ctypes.byref(library))
+
+	if ft.FT_New_Memory_Face(library, font, len(font), 0, ctypes.byref(face)):
+		raise ValueError("%s: could not open font" % filename)
+
+	# freetype reads the font in place, it must outlive the face
+	return library, face, font
+
+def bake(filename, sizes, charset, distance_sizes=[]):
+	ft = load_freetype()
+	library, face, font = open_face(ft, filename)
+
+	pages = [bake_page(ft, face, size, charset) for size in sizes]
+	pages += [bake_page(ft, face, size, charset, True) for size in distance_sizes]
+
+	ft.FT_Done_Face(face)
+	ft.FT_Done_FreeType(library)
+
+	# tables for every page come first, then the bitmaps so they stay aligned
+	offset = struct.calcsize(HEADER_FORMAT) + struct.calcsize(PAGE_FORMAT) * len(pages)
+	index = []
+	tables = []
+
+	for size, flags, used, glyphs, kerning, bitmap in pages:
+		glyph_offset = offset
+		kerning_offset = glyph_offset + len(glyphs) * struct.calcsize(GLYPH_FORMAT)
+		offset = kerning_offset + len(kerning) * struct.calcsize(KERNING_FORMAT)
+		index.append([int(size * 64), ATLAS_WIDTH, ATLAS_HEIGHT, used, flags, len(glyphs), glyph_offset, len(kerning), kerning_offset])
+		tables.append(b"".join(glyphs) + b"".join(kerning))
+
+	bitmaps = []
+
+	for entry, page in zip(index, pages):
+		bitmap = page[5]
+		aligned = align(offset, DATA_ALIGNMENT)
+		entry.append(aligned)
+		bitmaps.append(b"\0" * (aligned - offset) + bitmap)
+		offset = aligned + len(bitmap)
+
+	header = struct.pack(HEADER_FORMAT, GLYPHS_MAGIC, GLYPHS_VERSION, len(pages))
+	index = [struct.pack(PAGE_FORMAT, *entry) for entry in index]
+	return header + b"".join(index) + b"".join(tables) + b"".join(bitmaps)
+
+if __name__ == "__main__":
+	sizes = []
+	distance_sizes = []
+	charset = parse_charset("0x20-0x7e")
+	args = []
+
+	for arg in sys.argv[1:]:
+		if arg.startswith("--sizes="):
+			sizes = [float(size) for size in arg[len("--sizes="):].split(",")]
+		elif arg.startswith("--distance-field="):
+			distance_sizes = [float(size) for size in arg[len("--distance-field="):].split(",")]
+		elif arg.startswith("--charset="):
+			charset = parse_charset(arg[len("--charset="):])
+		else:
+			args.append(arg)
+
+	glyphs = bake(args[1], sizes, charset, distance_sizes)
+
+	if os.path.dirname(args[0]) != "":
+		if not os.path.exists(os.path.dirname(args[0])):
+			try:
+				os.makedirs(os.path.dirname(args[0]))
+			except OSError as exc: # Guard against race condition
+				if exc.errno != errno.EEXIST:
+					raise
+
+	with open(args[0], 'wb') as f:
+		f.write(glyphs)
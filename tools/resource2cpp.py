@@ -1,5 +1,17 @@
 #!/usr/bin/python
-import sys, os, re, json, errno
+import sys, os, re, errno, struct
+
+# FNV-1a parameters. the offset basis is replaced by a seed chosen at generation
+# time so that every resource name lands in its own slot of the table
+FNV_PRIME = 16777619
+FNV_OFFSET_BASIS = 2166136261
+
+# must match tools/resourcepack.py
+PACK_MAGIC = b"RSPK"
+PACK_VERSION = 1
+HEADER_FORMAT = "<4sIII"
+ENTRY_FORMAT = "<IIIIIIII"
+ENTRY_FLAG_COMPRESSED = 1
 
 def clean(s):
 	# Remove invalid characters
@@ -8,16 +20,113 @@ def clean(s):
 	s = re.sub('^[^a-zA-Z_]+', '', s)
 	return s
 
-def generate_cpp(filename, header, cdata):
-	initialisations = ""
-	buffers = ""
+def fnv1a(s, seed):
+	h = seed
+
+	for c in bytearray(s.encode('utf-8')):
+		h ^= c
+		h = (h * FNV_PRIME) & 0xFFFFFFFF
+
+	return h
+
+def read_pack(path, symbol):
+	with open(path, 'rb') as f:
+		pack = f.read()
+
+	magic, version, count, names_size = struct.unpack_from(HEADER_FORMAT, pack, 0)
+
+	if magic != PACK_MAGIC or version != PACK_VERSION:
+		raise ValueError("%s is not a version %d resource pack" % (path, PACK_VERSION))
+
+	resources = dict()
+	offset = struct.calcsize(HEADER_FORMAT)
+
+	for i in range(count):
+		name_offset, name_length, data_offset, size, raw_size, flags, _, _ = struct.unpack_from(ENTRY_FORMAT, pack, offset)
+		name = pack[name_offset:name_offset+name_length].decode('utf-8')
+		offset += struct.calcsize(ENTRY_FORMAT)
+
+		if name in resources:
+			raise ValueError("%s holds %s twice" % (path, name))
+
+		resources[name] = {
+			"symbol": symbol,
+			"offset": data_offset,
+			"size": size,
+			"raw_size": raw_size,
+			"compressed": (flags & ENTRY_FLAG_COMPRESSED) != 0
+		}
+
+	return resources
+
+def pack_symbol(path):
+	return "resource_pack_%s" % (clean(os.path.basename(path).split('.')[0]))
+
+def perfect_hash(keys):
+	# start with the smallest power of two that fits every key and double it
+	# if we cannot find a collision free seed in a reasonable number of tries
+	size = 1
+
+	while size < len(keys):
+		size *= 2
+
+	while True:
+		for seed in range(FNV_OFFSET_BASIS, FNV_OFFSET_BASIS + 4096):
+			slots = [-1] * size
+			hashes = [0] * size
+
+			for index, key in enumerate(keys):
+				h = fnv1a(key, seed)
+				slot = h & (size - 1)
+
+				if slots[slot] != -1:
+					break
+
+				slots[slot] = index
+				hashes[slot] = h
+			else:
+				return seed, size, slots, hashes
+
+		size *= 2
+
+def generate_asm(filename, packs):
+	incbins = ""
+
+	for path in packs:
+		symbol = pack_symbol(path)
+		incbins += "\t.global %s\n" % (symbol)
+		incbins += "\t.type %s, %%object\n" % (symbol)
+		incbins += "\t.balign 16\n"
+		incbins += "%s:\n" % (symbol)
+		incbins += "\t.incbin \"%s\"\n" % (os.path.abspath(path))
+		incbins += "\t.size %s, . - %s\n\n" % (symbol, symbol)
+
+	return """/*
+ * %s - AUTOGENERATED RESOURCE FILE
+ *
+ * Copyright (C) 2016 David "Davee" Morgan
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license.  See the LICENSE file for details.
+ */
+
+	.section .rodata
+%s""" % (filename, incbins[:-1])
+
+def generate_cpp(filename, header, cdata, keys, packs):
+	resources = ""
+	symbols = ""
 	
-	for key in cdata:
-		initialisations += "\t\t{ \"%s\", { %s, sizeof(%s) } },\n" % (key, clean(key[5:]), clean(key[5:]))
-		buffers += "\t%s\n" % (cdata[key])
+	for path in packs:
+		symbols += "\textern const char %s[];\n" % (pack_symbol(path))
 
-	initialisations = initialisations[:-2]
-	buffers = buffers[:-1]
+	for key in keys:
+		res = cdata[key]
+		compressed = "true" if res["compressed"] else "false"
+		resources += "\t\t{ \"%s\", %s + 0x%X, %d, %d, %s },\n" % (key, res["symbol"], res["offset"], res["size"], res["raw_size"], compressed)
+
+	resources = resources[:-2]
+	symbols = symbols[:-1]
 
 	return """/*
  * %s - AUTOGENERATED RESOURCE FILE
@@ -30,28 +139,50 @@ def generate_cpp(filename, header, cdata):
 
 #include \"%s\"
 
+#include <cstring>
+
+// the packs are linked in by the matching assembly file
+extern "C"
+{
+%s
+}
+
 namespace {
+	// sorted by name. only holds address constants so it is constant
+	// initialised and nothing runs before main
+	const ResourceFactory::Resource resources[] =
+	{
 %s
+	};
 }
 
-ResourceFactory::ResourceFactory(std::unordered_map<std::string, Resource> resources)
-	: m_resources(resources)
+const ResourceFactory::Resource *ResourceFactory::find(ResourceFactory::Id id)
 {
+	auto slot = id & ResourceTable::mask;
+	auto index = ResourceTable::indices[slot];
+
+	if (index < 0 || ResourceTable::ids[slot] != id)
+		return nullptr;
+
+	return &resources[index];
 }
 
-ResourceFactory *ResourceFactory::instance(void)
+const ResourceFactory::Resource *ResourceFactory::find(ResourceFactory::Name name)
 {
-	static ResourceFactory factory(
-		// initialisations go here
-	{
-%s
-	});
+	auto res = find(name.id);
+
+	// the hash is only perfect over our own names, anything else could collide
+	if (!res || std::strlen(res->name) != name.length || std::memcmp(res->name, name.string, name.length) != 0)
+		return nullptr;
 
-	return &factory;
+	return res;
 }
-""" % (filename, os.path.basename(header), buffers, initialisations)
+""" % (filename, os.path.basename(header), symbols, resources)
+
+def generate_hpp(filename, seed, size, slots, hashes):
+	indices = ", ".join(["%d" % (slot) for slot in slots])
+	ids = ", ".join(["0x%08Xu" % (h) for h in hashes])
 
-def generate_hpp(filename):
 	return """/*
  * %s - AUTOGENERATED RESOURCE FILE
  *
@@ -64,68 +195,120 @@ def generate_hpp(filename):
 #ifndef AUTOGEN_%s_RESOURCE_H
 #define AUTOGEN_%s_RESOURCE_H
 
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
+namespace ResourceTable
+{
+	constexpr std::uint32_t seed = 0x%08Xu;
+	constexpr std::uint32_t mask = 0x%Xu;
+
+	// resource index and full hash for each slot, -1 for an empty slot
+	constexpr short indices[] = { %s };
+	constexpr std::uint32_t ids[] = { %s };
+}
+
 class ResourceFactory
 {
 public:
+	using Id = std::uint32_t;
+
 	struct Resource
 	{
+		const char *name;
 		const char *data;
 		unsigned int size;
+
+		// size once inflated, equal to size for resources stored raw
+		unsigned int rawSize;
+		bool compressed;
 	};
 
 public:
-	static const Resource *find(const std::string& name)
+	static constexpr Id id(const char *name, std::size_t length)
+	{
+		std::uint32_t hash = ResourceTable::seed;
+
+		for (std::size_t i = 0; i < length; ++i)
+		{
+			hash ^= static_cast<unsigned char>(name[i]);
+			hash *= %du;
+		}
+
+		return hash;
+	}
+
+	// a name with its hash worked out ahead of time, see operator"" _rsc
+	struct Name
 	{
-		auto it = instance()->m_resources.find(name);
+		const char *string;
+		std::size_t length;
+		Id id;
+	};
 
-		if (it == instance()->m_resources.end())
-			return nullptr;
-		
-		return &(it->second);
+	static constexpr bool contains(Id id)
+	{
+		return ResourceTable::indices[id & ResourceTable::mask] >= 0 && ResourceTable::ids[id & ResourceTable::mask] == id;
 	}
 
-private:
-	ResourceFactory(std::unordered_map<std::string, Resource> resources);
-	static ResourceFactory *instance(void);
+	static const Resource *find(Name name);
+
+	static const Resource *find(const char *name, std::size_t length)
+	{
+		return find(Name{ name, length, id(name, length) });
+	}
+
+	static const Resource *find(const std::string& name)
+	{
+		return find(name.data(), name.size());
+	}
 
 private:
-	std::unordered_map<std::string, Resource> m_resources;
+	static const Resource *find(Id id);
 };
 
-#endif // AUTOGEN_%s_RESOURCE_H
-""" % (filename, clean(filename), clean(filename), clean(filename))
+// "rsc:/file"_rsc hashes the name at compile time. the name is kept so a
+// lookup can tell our resources from anything else that hashes the same
+constexpr ResourceFactory::Name operator"" _rsc(const char *name, std::size_t length)
+{
+	return { name, length, ResourceFactory::id(name, length) };
+}
 
-if __name__ == "__main__":
-	cdata = dict()
-	for res in sys.argv[3:]:
-		with open(res, 'r') as f:
-			data = f.read()
-			cdata.update(json.loads(data))
-	
-	resource_cpp = generate_cpp(sys.argv[1], sys.argv[2], cdata)
-	resource_hpp = generate_hpp(sys.argv[2])
+#endif // AUTOGEN_%s_RESOURCE_H
+""" % (filename, clean(filename), clean(filename), seed, size - 1, indices, ids, FNV_PRIME, clean(filename))
 
-	if os.path.dirname(sys.argv[1]) != "":
-		if not os.path.exists(os.path.dirname(sys.argv[1])):
+def write(path, contents):
+	if os.path.dirname(path) != "":
+		if not os.path.exists(os.path.dirname(path)):
 			try:
-				os.makedirs(os.path.dirname(sys.argv[1]))
+				os.makedirs(os.path.dirname(path))
 			except OSError as exc: # Guard against race condition
 				if exc.errno != errno.EEXIST:
 					raise
 
-	with open(sys.argv[1], "w") as f:
-		f.write(resource_cpp)
+	with open(path, "w") as f:
+		f.write(contents)
+
+if __name__ == "__main__":
+	packs = sys.argv[4:]
+	cdata = dict()
+
+	for pack in packs:
+		resources = read_pack(pack, pack_symbol(pack))
+
+		# one would silently replace the other in the table
+		for name in resources:
+			if name in cdata:
+				raise ValueError("%s is in both %s and %s" % (name, cdata[name]["pack"], pack))
+
+			resources[name]["pack"] = pack
+
+		cdata.update(resources)
 	
-	if os.path.dirname(sys.argv[2]) != "":
-		if not os.path.exists(os.path.dirname(sys.argv[2])):
-			try:
-				os.makedirs(os.path.dirname(sys.argv[2]))
-			except OSError as exc: # Guard against race condition
-				if exc.errno != errno.EEXIST:
-					raise
+	keys = sorted(cdata.keys())
+	seed, size, slots, hashes = perfect_hash(keys)
 
-	with open(sys.argv[2], "w") as f:
-		f.write(resource_hpp)
+	write(sys.argv[1], generate_cpp(sys.argv[1], sys.argv[2], cdata, keys, packs))
+	write(sys.argv[2], generate_hpp(sys.argv[2], seed, size, slots, hashes))
+	write(sys.argv[3], generate_asm(sys.argv[3], packs))
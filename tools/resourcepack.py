@@ -1,38 +1,90 @@
 #!/usr/bin/python
-import sys, re, json, os, errno
+import sys, os, errno, struct, zlib
 
-def clean(s):
-	# Remove invalid characters
-	s = re.sub('[^0-9a-zA-Z_]', '', s)
-	# Remove leading characters until we find a letter or underscore
-	s = re.sub('^[^a-zA-Z_]+', '', s)
-	return s
+# pack layout, all little endian:
+#   header   magic, version, entry count, size of the name table
+#   entries  one per resource, see ENTRY_FORMAT
+#   names    nul terminated resource names
+#   payload  resource data, each aligned to PAYLOAD_ALIGNMENT from the pack start
+PACK_MAGIC = b"RSPK"
+PACK_VERSION = 1
+HEADER_FORMAT = "<4sIII"
 
-if __name__ == "__main__":
-	cdata = dict()
+# name offset, name length, data offset, stored size, raw size, flags, reserved
+ENTRY_FORMAT = "<IIIIIIII"
+ENTRY_FLAG_COMPRESSED = 1
 
-	for res in sys.argv[2:]:
-		binary_cdata = ""
-		
+# resources are used in place (eg. shader programs are handed straight to gxm),
+# so give them the same alignment a heap copy would have had
+PAYLOAD_ALIGNMENT = 16
+
+# resources smaller than this are not worth the cost of inflating at runtime
+COMPRESS_MIN_SIZE = 1024
+
+# and anything that does not shrink by at least an eighth is left raw
+COMPRESS_MIN_RATIO = 7.0 / 8.0
+
+def align(value, alignment):
+	return (value + alignment - 1) & ~(alignment - 1)
+
+def deflate(data):
+	# raw deflate stream, the zlib header and checksum are of no use to us
+	compressor = zlib.compressobj(9, zlib.DEFLATED, -15)
+	return compressor.compress(data) + compressor.flush()
+
+def build_pack(resources, compress):
+	entries = []
+	names = b""
+	
+	for res in resources:
 		with open(res, 'rb') as f:
 			data = f.read()
 		
-			for b in data:
-				binary_cdata += hex(ord(b)) + ", "
-		
-		binary_cdata = binary_cdata[:-2];
-		
-		resource_c = "static const char %s[] = { %s };" % (clean(res), binary_cdata)
-		resource_path = "rsc:/"+res
-		cdata[resource_path] = resource_c;
+		flags = 0
+		stored = data
+
+		if compress and len(data) >= COMPRESS_MIN_SIZE:
+			deflated = deflate(data)
+
+			if len(deflated) <= len(data) * COMPRESS_MIN_RATIO:
+				stored = deflated
+				flags |= ENTRY_FLAG_COMPRESSED
+
+		name = ("rsc:/" + res).encode('utf-8')
+		entries.append((len(names), name, stored, len(data), flags))
+		names += name + b"\0"
+
+	header_size = struct.calcsize(HEADER_FORMAT)
+	index_size = struct.calcsize(ENTRY_FORMAT) * len(entries)
+	names_offset = header_size + index_size
+	offset = align(names_offset + len(names), PAYLOAD_ALIGNMENT)
+
+	index = []
+	payload = []
+	end = names_offset + len(names)
+	
+	for name_offset, name, stored, raw_size, flags in entries:
+		index.append(struct.pack(ENTRY_FORMAT, names_offset + name_offset, len(name), offset, len(stored), raw_size, flags, 0, 0))
+		payload.append(b"\0" * (offset - end))
+		payload.append(stored)
+		end = offset + len(stored)
+		offset = align(end, PAYLOAD_ALIGNMENT)
+	
+	header = struct.pack(HEADER_FORMAT, PACK_MAGIC, PACK_VERSION, len(entries), len(names))
+	return header + b"".join(index) + names + b"".join(payload)
+
+if __name__ == "__main__":
+	compress = "--compress" in sys.argv
+	args = [arg for arg in sys.argv[1:] if arg != "--compress"]
+	pack = build_pack(args[1:], compress)
 	
-	if os.path.dirname(sys.argv[1]) != "":
-		if not os.path.exists(os.path.dirname(sys.argv[1])):
+	if os.path.dirname(args[0]) != "":
+		if not os.path.exists(os.path.dirname(args[0])):
 			try:
-				os.makedirs(os.path.dirname(sys.argv[1]))
+				os.makedirs(os.path.dirname(args[0]))
 			except OSError as exc: # Guard against race condition
 				if exc.errno != errno.EEXIST:
 					raise
 
-	with open(sys.argv[1], 'w') as f:
-		f.write(json.dumps(cdata))
+	with open(args[0], 'wb') as f:
+		f.write(pack)
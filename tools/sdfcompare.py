@@ -0,0 +1,125 @@
+#!/usr/bin/python
+import sys, time, math
+import glyphbake
+
+# compares drawing text from one distance field page against rasterising a
+# bitmap page per point size. for each size every glyph is reconstructed from
+# the field the way sdftext.frag.cg draws it, and compared with the bitmap
+# freetype renders at that size. also reports the time to bake the pages and
+# the atlas rows they use.
+#
+# freetype hints each size to the pixel grid, which a scaled field cannot do,
+# and that is most of the difference. --unhinted compares against unhinted
+# glyphs instead, leaving only the error from the field itself
+#
+# usage: sdfcompare.py [--sizes=8,10,12,18,20] [--reference=16] [--charset=...] [--unhinted] font.ttf
+
+def sample(rows, width, height, x, y):
+	# bilinear filtering with clamp to edge, as the atlas is sampled
+	x = min(max(x - 0.5, 0.0), width - 1.0)
+	y = min(max(y - 0.5, 0.0), height - 1.0)
+	x0 = int(x)
+	y0 = int(y)
+	x1 = min(x0 + 1, width - 1)
+	y1 = min(y0 + 1, height - 1)
+	fx = x - x0
+	fy = y - y0
+	top = rows[y0][x0] * (1 - fx) + rows[y0][x1] * fx
+	bottom = rows[y1][x0] * (1 - fx) + rows[y1][x1] * fx
+	return (top * (1 - fy) + bottom * fy) / 255.0
+
+def smoothstep(edge0, edge1, x):
+	t = min(max((x - edge0) / (edge1 - edge0), 0.0), 1.0)
+	return t * t * (3 - 2 * t)
+
+def compare_glyph(bitmap, field, scale):
+	width, height, rows, _, left, top = bitmap
+	field_width, field_height, field_rows, _, field_left, field_top = field
+
+	# the field changes by 1/(2*spread) per atlas texel. the shader smooths
+	# over half of fwidth, which is that per screen pixel for an axis aligned
+	# outline
+	edge = 0.5 / (2 * glyphbake.DISTANCE_FIELD_SPREAD * scale)
+	errors = []
+
+	# every pixel freetype covered, with a margin for anything the field
+	# draws outside it
+	for y in range(-1, height + 1):
+		for x in range(-1, width + 1):
+			expected = rows[y][x] / 255.0 if 0 <= x < width and 0 <= y < height else 0.0
+
+			# pixel centre relative to the pen, then into field texels
+			px = (left + x + 0.5) / scale
+			py = (top - y - 0.5) / scale
+			distance = sample(field_rows, field_width, field_height, px - field_left, field_top - py)
+			actual = smoothstep(0.5 - edge, 0.5 + edge, distance)
+			errors.append(actual - expected)
+
+	return errors
+
+def psnr(errors):
+	mse = sum(e * e for e in errors) / len(errors)
+	return float("inf") if mse == 0 else 10 * math.log10(1.0 / mse)
+
+def compare(filename, sizes, reference, charset, load_flags):
+	ft = glyphbake.load_freetype()
+	library, face, font = glyphbake.open_face(ft, filename)
+
+	start = time.time()
+	bitmap_pages = [glyphbake.bake_page(ft, face, size, charset) for size in sizes]
+	bitmap_time = time.time() - start
+
+	start = time.time()
+	field_page = glyphbake.bake_page(ft, face, reference, charset, True)
+	field_time = time.time() - start
+
+	ft.FT_Set_Char_Size(face, 0, int(reference * 64), glyphbake.HORIZONTAL_DPI, glyphbake.VERTICAL_DPI)
+	fields = dict((c, glyphbake.render_glyph(ft, face, c, True, load_flags)) for c in charset)
+
+	print("size   mean abs error   max abs error   psnr")
+
+	for size in sizes:
+		ft.FT_Set_Char_Size(face, 0, int(size * 64), glyphbake.HORIZONTAL_DPI, glyphbake.VERTICAL_DPI)
+		errors = []
+
+		for character in charset:
+			bitmap = glyphbake.render_glyph(ft, face, character, False, load_flags)
+
+			if bitmap is None or fields[character] is None or bitmap[0] == 0 or bitmap[1] == 0:
+				continue
+
+			errors += compare_glyph(bitmap, fields[character], size / reference)
+
+		mean = sum(abs(e) for e in errors) / len(errors)
+		worst = max(abs(e) for e in errors)
+		print("%4g   %14.4f   %13.4f   %.2fdB" % (size, mean, worst, psnr(errors)))
+
+	ft.FT_Done_Face(face)
+	ft.FT_Done_FreeType(library)
+
+	bitmap_rows = sum(page[2] for page in bitmap_pages)
+	print("")
+	print("bitmap: %d pages, %d atlas rows used, baked in %.1fms" % (len(bitmap_pages), bitmap_rows, bitmap_time * 1000))
+	print("distance field: 1 page, %d atlas rows used, baked in %.1fms" % (field_page[2], field_time * 1000))
+	print("atlas memory: %d bytes vs %d bytes" % (len(bitmap_pages) * glyphbake.ATLAS_WIDTH * glyphbake.ATLAS_HEIGHT, glyphbake.ATLAS_WIDTH * glyphbake.ATLAS_HEIGHT))
+
+if __name__ == "__main__":
+	sizes = [8, 10, 12, 18, 20]
+	reference = 16.0
+	charset = glyphbake.parse_charset("0x20-0x7e")
+	load_flags = glyphbake.FT_LOAD_DEFAULT
+	args = []
+
+	for arg in sys.argv[1:]:
+		if arg.startswith("--sizes="):
+			sizes = [float(size) for size in arg[len("--sizes="):].split(",")]
+		elif arg.startswith("--reference="):
+			reference = float(arg[len("--reference="):])
+		elif arg.startswith("--charset="):
+			charset = glyphbake.parse_charset(arg[len("--charset="):])
+		elif arg == "--unhinted":
+			load_flags = glyphbake.FT_LOAD_NO_HINTING
+		else:
+			args.append(arg)
+
+	compare(args[0], sizes, reference, charset, load_flags)
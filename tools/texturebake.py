@@ -0,0 +1,339 @@
+#!/usr/bin/python
+import sys, os, errno, struct, zlib
+
+# baked texture layout, all little endian:
+#   header   magic, version, format, width, height, stride, flags, data offset
+#   data     in exactly the layout GxmTexture samples from. stride is the size
+#            of a row of pixels, or a row of 4x4 blocks for compressed formats
+TEXTURE_MAGIC = b"RTEX"
+TEXTURE_VERSION = 1
+HEADER_FORMAT = "<4sIIIIIII"
+
+# must match GxmTexture::TextureFormat
+FORMAT_ARGB8 = 0
+FORMAT_U8_R111 = 1
+FORMAT_UBC1 = 2
+FORMAT_UBC3 = 3
+
+# format, block dimension, bytes per block
+FORMATS = {
+	"argb8": (FORMAT_ARGB8, 1, 4),
+	"u8": (FORMAT_U8_R111, 1, 1),
+	"ubc1": (FORMAT_UBC1, 4, 8),
+	"ubc3": (FORMAT_UBC3, 4, 16),
+}
+
+FLAG_SWIZZLED = 1
+
+# the data is copied straight into texture storage, keep it aligned like the
+# resource pack payload
+DATA_ALIGNMENT = 16
+
+PNG_SIGNATURE = b"\x89PNG\r\n\x1a\n"
+
+# components per pixel for each png colour type
+PNG_CHANNELS = { 0: 1, 2: 3, 3: 1, 4: 2, 6: 4 }
+
+def align(value, alignment):
+	return (value + alignment - 1) & ~(alignment - 1)
+
+def paeth(a, b, c):
+	p = a + b - c
+	pa = abs(p - a)
+	pb = abs(p - b)
+	pc = abs(p - c)
+
+	if pa <= pb and pa <= pc:
+		return a
+	if pb <= pc:
+		return b
+	return c
+
+def unfilter(data, width, height, bpp):
+	stride = width * bpp
+	rows = []
+	prev = bytearray(stride)
+	pos = 0
+
+	for y in range(height):
+		kind = data[pos]
+		row = bytearray(data[pos + 1:pos + 1 + stride])
+		pos += 1 + stride
+
+		if kind == 1:
+			for i in range(bpp, stride):
+				row[i] = (row[i] + row[i - bpp]) & 0xff
+		elif kind == 2:
+			for i in range(stride):
+				row[i] = (row[i] + prev[i]) & 0xff
+		elif kind == 3:
+			for i in range(stride):
+				left = row[i - bpp] if i >= bpp else 0
+				row[i] = (row[i] + ((left + prev[i]) >> 1)) & 0xff
+		elif kind == 4:
+			for i in range(stride):
+				left = row[i - bpp] if i >= bpp else 0
+				upleft = prev[i - bpp] if i >= bpp else 0
+				row[i] = (row[i] + paeth(left, prev[i], upleft)) & 0xff
+		elif kind != 0:
+			raise ValueError("bad png filter type %d" % kind)
+
+		rows.append(row)
+		prev = row
+
+	return rows
+
+def read_png(filename):
+	with open(filename, 'rb') as f:
+		data = f.read()
+
+	if data[:8] != PNG_SIGNATURE:
+		raise ValueError("%s: not a png" % filename)
+
+	pos = 8
+	idat = []
+	palette = None
+	trns = None
+
+	while pos < len(data):
+		length, kind = struct.unpack(">I4s", data[pos:pos + 8])
+		chunk = data[pos + 8:pos + 8 + length]
+		pos += 12 + length
+
+		if kind == b"IHDR":
+			width, height, depth, colour, _, _, interlace = struct.unpack(">IIBBBBB", chunk)
+		elif kind == b"PLTE":
+			palette = bytearray(chunk)
+		elif kind == b"tRNS":
+			trns = bytearray(chunk)
+		elif kind == b"IDAT":
+			idat.append(chunk)
+		elif kind == b"IEND":
+			break
+
+	# the installer assets are all plain 8 bit images. anything else can be
+	# re-exported rather than teaching this script the rest of the spec
+	if depth != 8 or interlace != 0 or colour not in PNG_CHANNELS:
+		raise ValueError("%s: only 8 bit non-interlaced pngs are supported" % filename)
+
+	channels = PNG_CHANNELS[colour]
+	rows = unfilter(bytearray(zlib.decompress(b"".join(idat))), width, height, channels)
+	pixels = bytearray(width * height * 4)
+
+	# expand to rgba, the same conversion png::convert_color_space performs
+	for y, row in enumerate(rows):
+		out = y * width * 4
+
+		for x in range(width):
+			if colour == 6:
+				r, g, b, a = row[x*4:x*4 + 4]
+			elif colour == 2:
+				r, g, b = row[x*3:x*3 + 3]
+				a = 0xff
+			elif colour == 4:
+				r = g = b = row[x*2]
+				a = row[x*2 + 1]
+			elif colour == 0:
+				r = g = b = row[x]
+				a = 0xff
+			else:
+				index = row[x]
+				r, g, b = palette[index*3:index*3 + 3]
+				a = trns[index] if trns is not None and index < len(trns) else 0xff
+
+			pixels[out + x*4:out + x*4 + 4] = bytearray((r, g, b, a))
+
+	return width, height, pixels
+
+def expand565(colour):
+	r = (colour >> 11) & 0x1f
+	g = (colour >> 5) & 0x3f
+	b = colour & 0x1f
+	return ((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2))
+
+def pack565(colour):
+	r, g, b = colour
+	return ((r * 31 + 127) // 255) << 11 | ((g * 63 + 127) // 255) << 5 | ((b * 31 + 127) // 255)
+
+def distance(a, b):
+	return (a[0] - b[0]) ** 2 + (a[1] - b[1]) ** 2 + (a[2] - b[2]) ** 2
+
+def principal_endpoints(colours):
+	# fit a line through the block's colours and use the extremes along it
+	count = float(len(colours))
+	mean = [sum(c[i] for c in colours) / count for i in range(3)]
+	cov = [[sum((c[i] - mean[i]) * (c[j] - mean[j]) for c in colours) for j in range(3)] for i in range(3)]
+	axis = [max(c[i] for c in colours) - min(c[i] for c in colours) for i in range(3)]
+
+	for _ in range(4):
+		axis = [sum(cov[i][j] * axis[j] for j in range(3)) for i in range(3)]
+		length = max(abs(v) for v in axis)
+
+		if length == 0:
+			break
+
+		axis = [v / float(length) for v in axis]
+
+	project = lambda c: sum((c[i] - mean[i]) * axis[i] for i in range(3))
+	return max(colours, key=project), min(colours, key=project)
+
+def encode_colour_block(block, punchthrough):
+	# with punchthrough alpha the 3 colour mode is used and index 3 is
+	# transparent, as ubc1 defines it
+	transparent = [a < 128 for _, _, _, a in block] if punchthrough else [False] * 16
+	opaque = [p[:3] for p, t in zip(block, transparent) if not t]
+
+	if not opaque:
+		return struct.pack("<HHI", 0, 0xffff, 0xffffffff)
+
+	first, second = principal_endpoints(opaque)
+	c0 = pack565(first)
+	c1 = pack565(second)
+
+	# c0 > c1 selects 4 colour mode and c0 <= c1 selects 3 colour mode
+	if (any(transparent) and c0 > c1) or (not any(transparent) and c0 < c1):
+		c0, c1 = c1, c0
+
+	p0 = expand565(c0)
+	p1 = expand565(c1)
+
+	if c0 > c1:
+		palette = [p0, p1, tuple((2*a + b) // 3 for a, b in zip(p0, p1)), tuple((a + 2*b) // 3 for a, b in zip(p0, p1))]
+	else:
+		palette = [p0, p1, tuple((a + b) // 2 for a, b in zip(p0, p1))]
+
+	indices = 0
+
+	for i, pixel in enumerate(block):
+		if transparent[i]:
+			index = 3
+		elif c0 == c1:
+			index = 0
+		else:
+			index = min(range(len(palette)), key=lambda n: distance(pixel, palette[n]))
+
+		indices |= index << (2*i)
+
+	return struct.pack("<HHI", c0, c1, indices)
+
+def encode_alpha_block(block):
+	# interpolate 8 alphas between the block's extremes
+	a0 = max(p[3] for p in block)
+	a1 = min(p[3] for p in block)
+	palette = [a0, a1] + [((7 - n) * a0 + n * a1) // 7 for n in range(1, 7)]
+	indices = 0
+
+	for i, pixel in enumerate(block):
+		index = 0 if a0 == a1 else min(range(8), key=lambda n: abs(pixel[3] - palette[n]))
+		indices |= index << (3*i)
+
+	return struct.pack("<BB", a0, a1) + struct.pack("<Q", indices)[:6]
+
+def compress(pixels, width, height, format):
+	out = []
+
+	for by in range(0, height, 4):
+		for bx in range(0, width, 4):
+			block = []
+
+			# edges of odd sized textures repeat the last row and column
+			for y in range(by, by + 4):
+				for x in range(bx, bx + 4):
+					src = (min(y, height - 1) * width + min(x, width - 1)) * 4
+					block.append(tuple(pixels[src:src + 4]))
+
+			if format == FORMAT_UBC3:
+				out.append(encode_alpha_block(block))
+				out.append(encode_colour_block(block, False))
+			else:
+				out.append(encode_colour_block(block, True))
+
+	return bytearray(b"".join(out))
+
+def convert(pixels, width, height, format):
+	# argb8 keeps the byte order the png loader has always uploaded, u8 keeps
+	# only the alpha channel like the glyph atlas
+	if format == FORMAT_ARGB8:
+		return pixels
+
+	if format == FORMAT_U8_R111:
+		return pixels[3::4]
+
+	return compress(pixels, width, height, format)
+
+def morton(x, y, bits):
+	index = 0
+
+	for bit in range(bits):
+		index |= ((x >> bit) & 1) << (2*bit)
+		index |= ((y >> bit) & 1) << (2*bit + 1)
+
+	return index
+
+def swizzle(data, width, height, bpp):
+	# interleave the low bits of x and y over the smaller dimension, the
+	# remaining high bits of the larger one select consecutive square blocks
+	bits = min(width, height).bit_length() - 1
+	block = 1 << bits
+	out = bytearray(len(data))
+
+	for y in range(height):
+		for x in range(width):
+			tile = (y >> bits) * (width >> bits) + (x >> bits)
+			index = tile * block * block + morton(x & (block - 1), y & (block - 1), bits)
+			src = (y * width + x) * bpp
+			out[index*bpp:index*bpp + bpp] = data[src:src + bpp]
+
+	return out
+
+def bake(filename, format_name, swizzled):
+	width, height, pixels = read_png(filename)
+
+	# opaque images only need the smaller of the compressed formats
+	if format_name == "ubc":
+		format_name = "ubc1" if all(a == 0xff for a in pixels[3::4]) else "ubc3"
+
+	format, block, block_size = FORMATS[format_name]
+	data = convert(pixels, width, height, format)
+	flags = 0
+
+	# gxm only samples block compressed textures from the swizzled layout
+	if block > 1:
+		swizzled = True
+
+	if swizzled:
+		if width & (width - 1) or height & (height - 1) or width < block or height < block:
+			raise ValueError("%s: swizzled textures must have power of two dimensions" % filename)
+
+		# compressed textures are swizzled a whole block at a time
+		data = swizzle(data, width // block, height // block, block_size)
+		flags |= FLAG_SWIZZLED
+
+	stride = (width + block - 1) // block * block_size
+	offset = align(struct.calcsize(HEADER_FORMAT), DATA_ALIGNMENT)
+	header = struct.pack(HEADER_FORMAT, TEXTURE_MAGIC, TEXTURE_VERSION, format, width, height, stride, flags, offset)
+	return header + b"\0" * (offset - len(header)) + bytes(data)
+
+if __name__ == "__main__":
+	swizzled = "--swizzle" in sys.argv
+	format_name = "argb8"
+	args = []
+
+	for arg in sys.argv[1:]:
+		if arg.startswith("--format="):
+			format_name = arg[len("--format="):]
+		elif arg != "--swizzle":
+			args.append(arg)
+
+	texture = bake(args[1], format_name, swizzled)
+
+	if os.path.dirname(args[0]) != "":
+		if not os.path.exists(os.path.dirname(args[0])):
+			try:
+				os.makedirs(os.path.dirname(args[0]))
+			except OSError as exc: # Guard against race condition
+				if exc.errno != errno.EEXIST:
+					raise
+
+	with open(args[0], 'wb') as f:
+		f.write(texture)